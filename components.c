@@ -0,0 +1,462 @@
+/*
+ This file is part of QRATPre+.
+
+ Copyright 2019
+ Florian Lonsing, Stanford University, USA.
+
+ Copyright 2018
+ Florian Lonsing, Vienna University of Technology, Austria.
+
+ QRATPre+ is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or (at
+ your option) any later version.
+
+ QRATPre+ is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with QRATPre+.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <assert.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "components.h"
+#include "qbce_qrat_plus.h"
+#include "parse.h"
+#include "util.h"
+
+/* Statistics of the instances of components which are added to the
+   statistics of 'qr'. */
+#define COMPONENT_STATS(STAT)                           \
+  STAT (cnt_redundant_literals)                         \
+  STAT (cnt_qbce_checks)                                \
+  STAT (cnt_qratu_checks)                               \
+  STAT (qrat_qbcp_checks)                               \
+  STAT (limit_qbcp_cur_props_reached)                   \
+  STAT (qbcp_total_props)                               \
+  STAT (qbcp_successful_checks_props)                   \
+  STAT (qrat_qbcp_successful_checks)                    \
+  STAT (total_assignments)                              \
+  STAT (qbcp_total_eabs_nestings)                       \
+  STAT (qbcp_total_calls)                               \
+  STAT (clause_redundancy_or_checks)                    \
+  STAT (clause_redundancy_or_checks_lits_seen)          \
+  STAT (clause_redundancy_or_checks_sig_filtered)       \
+  STAT (cnt_pivots_over_occ_limit)                      \
+  STAT (cnt_resolvent_limit_reached)                    \
+  STAT (cnt_witness_positions)                          \
+  STAT (sum_witness_positions)                          \
+  STAT (cnt_prop_cache_lookups)                         \
+  STAT (cnt_prop_cache_hits)                            \
+  STAT (cnt_prop_cache_decided)                         \
+  STAT (cnt_els_substituted_vars)                       \
+  STAT (cnt_els_deleted_clauses)                        \
+  STAT (cnt_subsumed_clauses)                           \
+  STAT (cnt_pure_lit_clauses)                           \
+  STAT (cnt_pure_lit_univ_lits)                         \
+  STAT (cnt_diminishing_cutoffs)
+
+/* Variable-disjoint part of the formula, preprocessed by its own
+   instance. */
+typedef struct Component Component;
+struct Component
+{
+  /* Variables grouped by qblocks in prefix order: 'vars[i]' has ID 'i + 1'
+     in the instance. */
+  VarIDStack vars;
+  /* Clauses in the order of the clause list: 'clauses[i]' has ID 'i + 1'
+     in the instance. */
+  ClausePtrStack clauses;
+  /* Clauses remaining after preprocessing, each given by its position on
+     'clauses' followed by its literals and 0. */
+  LitIDStack result;
+  unsigned int cnt_remaining_clauses;
+  double time;
+};
+
+/* Components to be preprocessed by a pool of threads. */
+typedef struct ComponentPool ComponentPool;
+struct ComponentPool
+{
+  QRATPrePlus *qr;
+  /* Components ordered by decreasing number of clauses, such that large
+     components are started first. */
+  Component **order;
+  unsigned int num_comps;
+  unsigned int next;
+  /* IDs of variables in the instances of their components. */
+  VarID *local_ids;
+  /* Protects 'next' and all modifications of 'qr'. */
+  pthread_mutex_t lock;
+};
+
+static VarID
+find_root (VarID *parent, VarID v)
+{
+  while (parent[v] != v)
+    {
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+    }
+  return v;
+}
+
+static int
+compare_components_by_size (const void * cp1, const void * cp2)
+{
+  Component *c1 = *(Component **) cp1;
+  Component *c2 = *(Component **) cp2;
+  if (COUNT_STACK (c1->clauses) != COUNT_STACK (c2->clauses))
+    return COUNT_STACK (c1->clauses) > COUNT_STACK (c2->clauses) ? -1 : 1;
+  return c1 < c2 ? -1 : (c1 > c2);
+}
+
+/* Returns nonzero iff the unit clauses of 'qr' contain complementary
+   literals. Then QBCP finds all clauses of the formula to be asymmetric
+   tautologies, but not the clauses of the other components. */
+static int
+has_complementary_units (QRATPrePlus * qr)
+{
+  int result = 0;
+  Clause **cp, **ce;
+  for (cp = qr->unit_input_clauses.start, ce = qr->unit_input_clauses.top;
+       !result && cp < ce; cp++)
+    if (!(*cp)->redundant)
+      {
+        LitID lit = (*cp)->lits[0];
+        Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+        result = LIT_NEG (lit) ? VAR_POS_MARKED (var) : VAR_NEG_MARKED (var);
+        if (LIT_NEG (lit))
+          VAR_NEG_MARK (var);
+        else
+          VAR_POS_MARK (var);
+      }
+  for (cp = qr->unit_input_clauses.start; cp < ce; cp++)
+    VAR_UNMARK (LIT2VARPTR (qr->pcnf.vars, (*cp)->lits[0]));
+  return result;
+}
+
+/* Create an instance with the configuration of 'qr' containing the
+   clauses of 'comp' and the projection of the prefix to its variables. */
+static QRATPrePlus *
+create_component_instance (QRATPrePlus * qr, Component *comp,
+                           VarID *local_ids)
+{
+  QRATPrePlus *sub = qratpreplus_create ();
+  sub->options = qr->options;
+  /* Options applying to the entire run are handled by 'qr'. */
+  sub->options.in_filename = 0;
+  sub->options.in = stdin;
+  sub->options.max_time = 0;
+  sub->options.verbosity = 0;
+  sub->options.threads = 1;
+  sub->options.formula_stats = 0;
+  sub->options.components = 0;
+  sub->limit_qbcp_cur_props = qr->limit_qbcp_cur_props;
+  sub->limit_max_occ_cnt = qr->limit_max_occ_cnt;
+  sub->limit_max_clause_len = qr->limit_max_clause_len;
+  sub->limit_min_clause_len = qr->limit_min_clause_len;
+  sub->limit_max_resolvents = qr->limit_max_resolvents;
+  sub->limit_global_iterations = qr->limit_global_iterations;
+  sub->min_elim_rate = qr->min_elim_rate;
+  sub->soft_time_limit = qr->soft_time_limit;
+  sub->start_time = qr->start_time;
+
+  qratpreplus_declare_max_var_id (sub, COUNT_STACK (comp->vars));
+  QBlock *qblock = 0;
+  VarID *vp, *ve;
+  for (vp = comp->vars.start, ve = comp->vars.top; vp < ve; vp++)
+    {
+      Var *var = VARID2VARPTR (qr->pcnf.vars, *vp);
+      if (var->qblock != qblock)
+        {
+          if (qblock)
+            qratpreplus_add_var_to_qblock (sub, 0);
+          qblock = var->qblock;
+          qratpreplus_new_qblock (sub, qblock->type == QTYPE_EXISTS ? -1 : 1);
+        }
+      qratpreplus_add_var_to_qblock (sub, local_ids[*vp]);
+    }
+  qratpreplus_add_var_to_qblock (sub, 0);
+
+  Clause **cp, **ce;
+  for (cp = comp->clauses.start, ce = comp->clauses.top; cp < ce; cp++)
+    {
+      Clause *c = *cp;
+      LitID *p, *e;
+      for (p = c->lits, e = p + c->num_lits; p < e; p++)
+        {
+          int id = local_ids[LIT2VARID (*p)];
+          qratpreplus_add_literal (sub, LIT_NEG (*p) ? -id : id);
+        }
+      qratpreplus_add_literal (sub, 0);
+    }
+  return sub;
+}
+
+/* Collect the remaining clauses of instance 'sub' of 'comp' with literals
+   in terms of the variables of 'qr' and add the statistics of 'sub' to
+   'qr'. */
+static void
+collect_component_result (QRATPrePlus * qr, Component *comp,
+                          QRATPrePlus * sub)
+{
+  Clause *c;
+  for (c = sub->pcnf.clauses.first; c; c = c->link.next)
+    if (!c->redundant)
+      {
+        assert (c->id >= 1 && c->id <= COUNT_STACK (comp->clauses));
+        PUSH_STACK (qr->mm, comp->result, c->id - 1);
+        LitID *p, *e;
+        for (p = c->lits, e = p + c->num_lits; p < e; p++)
+          {
+            LitID id = comp->vars.start[LIT2VARID (*p) - 1];
+            PUSH_STACK (qr->mm, comp->result, LIT_NEG (*p) ? -id : id);
+          }
+        PUSH_STACK (qr->mm, comp->result, 0);
+        comp->cnt_remaining_clauses++;
+      }
+
+#define MERGE_STAT(member)                      \
+  qr->member += sub->member;
+  COMPONENT_STATS (MERGE_STAT)
+#undef MERGE_STAT
+  if (sub->cnt_global_iterations > qr->cnt_global_iterations)
+    qr->cnt_global_iterations = sub->cnt_global_iterations;
+  if (sub->time_exceeded)
+    qr->time_exceeded = 1;
+}
+
+static void *
+run_component_worker (void *arg)
+{
+  ComponentPool *pool = arg;
+  QRATPrePlus *qr = pool->qr;
+  for (;;)
+    {
+      pthread_mutex_lock (&pool->lock);
+      Component *comp = pool->next < pool->num_comps ?
+        pool->order[pool->next++] : 0;
+      pthread_mutex_unlock (&pool->lock);
+      if (!comp)
+        break;
+
+      double start = wall_time_stamp ();
+      QRATPrePlus *sub = create_component_instance (qr, comp,
+                                                    pool->local_ids);
+      qratpreplus_preprocess (sub);
+      comp->time = wall_time_stamp () - start;
+
+      pthread_mutex_lock (&pool->lock);
+      collect_component_result (qr, comp, sub);
+      pthread_mutex_unlock (&pool->lock);
+      qratpreplus_delete (sub);
+    }
+  return 0;
+}
+
+static void
+run_component_pool (QRATPrePlus * qr, ComponentPool *pool)
+{
+  unsigned int i, num_threads = qr->options.threads < pool->num_comps ?
+    qr->options.threads : pool->num_comps;
+  pthread_t *threads = mm_malloc (qr->mm, num_threads * sizeof (pthread_t));
+  int *started = mm_malloc (qr->mm, num_threads * sizeof (int));
+  pthread_mutex_init (&pool->lock, 0);
+  /* If a thread cannot be created, then the others take over its share. */
+  for (i = 1; i < num_threads; i++)
+    started[i] = !pthread_create (threads + i, 0, run_component_worker, pool);
+  run_component_worker (pool);
+  for (i = 1; i < num_threads; i++)
+    if (started[i])
+      pthread_join (threads[i], 0);
+  pthread_mutex_destroy (&pool->lock);
+  mm_free (qr->mm, threads, num_threads * sizeof (pthread_t));
+  mm_free (qr->mm, started, num_threads * sizeof (int));
+}
+
+/* Replace the clauses of 'qr' by the remaining clauses of the instances
+   and rebuild the occurrences. */
+static void
+merge_component_results (QRATPrePlus * qr, Component *comps,
+                         unsigned int num_comps)
+{
+  Component *comp;
+  LitID *rp, *re;
+  for (comp = comps; comp < comps + num_comps; comp++)
+    {
+      rp = comp->result.start;
+      re = comp->result.top;
+      unsigned int pos;
+      for (pos = 0; pos < COUNT_STACK (comp->clauses); pos++)
+        {
+          if (rp < re && *rp == (LitID) pos)
+            {
+              while (*++rp)
+                ;
+              rp++;
+            }
+          else
+            {
+              Clause *c = comp->clauses.start[pos];
+              assert (!c->redundant);
+              c->redundant = 1;
+              PUSH_STACK (qr->mm, qr->redundant_clauses, c);
+              qr->cnt_redundant_clauses++;
+            }
+        }
+      assert (rp == re);
+    }
+
+  unlink_redundant_clauses (qr);
+  reset_occurrences (qr);
+
+  for (comp = comps; comp < comps + num_comps; comp++)
+    for (rp = comp->result.start, re = comp->result.top; rp < re; rp++)
+      {
+        Clause *c = comp->clauses.start[*rp];
+        assert (!c->redundant);
+        c->num_lits = 0;
+        while (*++rp)
+          {
+            assert (c->num_lits < c->size_lits);
+            c->lits[c->num_lits++] = *rp;
+          }
+        c->lw_index = c->rw_index = WATCHED_LIT_INVALID_INDEX;
+        int taut = reimport_clause (qr, c);
+        assert (!taut);
+      }
+}
+
+/* -------------------- START: PUBLIC FUNCTIONS -------------------- */
+
+int
+preprocess_components (QRATPrePlus * qr)
+{
+  double start = wall_time_stamp ();
+  if (has_complementary_units (qr))
+    return 0;
+  /* Redundant clauses must not connect components. */
+  unlink_redundant_clauses (qr);
+
+  /* Union-find over the variables of each clause, 'parent[v]' is 0 for
+     variables without occurrences. */
+  const size_t id_bytes = qr->pcnf.size_vars * sizeof (VarID);
+  VarID *parent = mm_malloc (qr->mm, id_bytes);
+  memset (parent, 0, id_bytes);
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    {
+      assert (c->num_lits > 0);
+      VarID root = 0;
+      LitID *p, *e;
+      for (p = c->lits, e = p + c->num_lits; p < e; p++)
+        {
+          VarID v = LIT2VARID (*p);
+          if (!parent[v])
+            parent[v] = v;
+          v = find_root (parent, v);
+          if (!root)
+            root = v;
+          else if (v != root)
+            parent[v] = root;
+        }
+    }
+
+  unsigned int num_comps = 0;
+  VarID v;
+  for (v = 1; v < qr->pcnf.size_vars; v++)
+    if (parent[v] == v)
+      num_comps++;
+  if (num_comps < 2)
+    {
+      mm_free (qr->mm, parent, id_bytes);
+      return 0;
+    }
+
+  Component *comps = mm_malloc (qr->mm, num_comps * sizeof (Component));
+  memset (comps, 0, num_comps * sizeof (Component));
+  /* Component of each root, and IDs of variables in the instances. */
+  VarID *comp_ids = mm_malloc (qr->mm, id_bytes);
+  memset (comp_ids, 0, id_bytes);
+  VarID *local_ids = mm_malloc (qr->mm, id_bytes);
+  unsigned int cnt = 0;
+  QBlock *s;
+  for (s = qr->pcnf.qblocks.first; s; s = s->link.next)
+    {
+      VarID *vp, *ve;
+      for (vp = s->vars.start, ve = s->vars.top; vp < ve; vp++)
+        {
+          if (!parent[*vp])
+            continue;
+          VarID root = find_root (parent, *vp);
+          /* Components are numbered by their first variable in prefix
+             order. */
+          if (!comp_ids[root])
+            comp_ids[root] = ++cnt;
+          Component *comp = comps + comp_ids[root] - 1;
+          PUSH_STACK (qr->mm, comp->vars, *vp);
+          local_ids[*vp] = COUNT_STACK (comp->vars);
+        }
+    }
+  assert (cnt == num_comps);
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    {
+      VarID root = find_root (parent, LIT2VARID (c->lits[0]));
+      PUSH_STACK (qr->mm, comps[comp_ids[root] - 1].clauses, c);
+    }
+
+  ComponentPool pool;
+  memset (&pool, 0, sizeof (pool));
+  pool.qr = qr;
+  pool.num_comps = num_comps;
+  pool.local_ids = local_ids;
+  pool.order = mm_malloc (qr->mm, num_comps * sizeof (Component *));
+  unsigned int i;
+  for (i = 0; i < num_comps; i++)
+    pool.order[i] = comps + i;
+  qsort (pool.order, num_comps, sizeof (Component *),
+         compare_components_by_size);
+
+  run_component_pool (qr, &pool);
+  merge_component_results (qr, comps, num_comps);
+
+  /* Statistics. */
+  qr->cnt_components = num_comps;
+  qr->max_component_clauses = COUNT_STACK (pool.order[0]->clauses);
+  for (i = 0; i < num_comps; i++)
+    {
+      Component *comp = pool.order[i];
+      if (comp->time > qr->max_component_time)
+        qr->max_component_time = comp->time;
+      if (qr->options.verbosity >= 1)
+        fprintf (stderr, "Component %u: %u variables, %u clauses, "
+                 "%u remaining clauses in %f sec\n", i,
+                 (unsigned int) COUNT_STACK (comp->vars),
+                 (unsigned int) COUNT_STACK (comp->clauses),
+                 comp->cnt_remaining_clauses, comp->time);
+      DELETE_STACK (qr->mm, comp->vars);
+      DELETE_STACK (qr->mm, comp->clauses);
+      DELETE_STACK (qr->mm, comp->result);
+    }
+  qr->components_time = wall_time_stamp () - start;
+  if (qr->options.verbosity >= 1)
+    fprintf (stderr, "Preprocessed %u components in %f sec\n", num_comps,
+             qr->components_time);
+
+  mm_free (qr->mm, pool.order, num_comps * sizeof (Component *));
+  mm_free (qr->mm, local_ids, id_bytes);
+  mm_free (qr->mm, comp_ids, id_bytes);
+  mm_free (qr->mm, comps, num_comps * sizeof (Component));
+  mm_free (qr->mm, parent, id_bytes);
+  return 1;
+}
+
+/* -------------------- END: PUBLIC FUNCTIONS -------------------- */
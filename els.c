@@ -0,0 +1,294 @@
+/*
+ This file is part of QRATPre+.
+
+ Copyright 2019
+ Florian Lonsing, Stanford University, USA.
+
+ Copyright 2018
+ Florian Lonsing, Vienna University of Technology, Austria.
+
+ QRATPre+ is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or (at
+ your option) any later version.
+
+ QRATPre+ is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with QRATPre+.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include "els.h"
+#include "qbce_qrat_plus.h"
+#include "parse.h"
+#include "util.h"
+
+/* Nodes of the implication graph are literals: node '2 * v' is the
+   positive and node '2 * v + 1' the negative literal of variable 'v'. */
+#define LIT2NODE(lit) (2 * LIT2VARID (lit) + LIT_NEG (lit))
+#define NODE2LIT(node) ((node) & 1 ? -(LitID) ((node) >> 1) : (LitID) ((node) >> 1))
+#define NODE_UNVISITED UINT_MAX
+
+/* Implication graph in compressed form: the successors of node 'n' are
+   'edges[offsets[n]]' to 'edges[offsets[n + 1] - 1]'. */
+struct ImplGraph
+{
+  unsigned int num_nodes;
+  unsigned int *offsets;
+  unsigned int *edges;
+  unsigned int num_edges;
+};
+
+typedef struct ImplGraph ImplGraph;
+
+/* A binary clause '(a b)' results in the implications '-a -> b' and
+   '-b -> a'. */
+static void
+build_impl_graph (QRATPrePlus * qr, ImplGraph *g)
+{
+  g->num_nodes = 2 * qr->pcnf.size_vars;
+  g->offsets = mm_malloc (qr->mm, (g->num_nodes + 1) * sizeof (unsigned int));
+  memset (g->offsets, 0, (g->num_nodes + 1) * sizeof (unsigned int));
+
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    if (!c->redundant && c->num_lits == 2)
+      {
+        g->offsets[LIT2NODE (-c->lits[0])]++;
+        g->offsets[LIT2NODE (-c->lits[1])]++;
+      }
+
+  /* Prefix sums, such that 'offsets[n]' is the end of the successors of
+     'n' while filling in edges below. */
+  unsigned int n, sum = 0;
+  for (n = 0; n <= g->num_nodes; n++)
+    {
+      sum += g->offsets[n];
+      g->offsets[n] = sum;
+    }
+  g->num_edges = sum;
+  g->edges = mm_malloc (qr->mm, (g->num_edges ? g->num_edges : 1) *
+                        sizeof (unsigned int));
+
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    if (!c->redundant && c->num_lits == 2)
+      {
+        g->edges[--g->offsets[LIT2NODE (-c->lits[0])]] = LIT2NODE (c->lits[1]);
+        g->edges[--g->offsets[LIT2NODE (-c->lits[1])]] = LIT2NODE (c->lits[0]);
+      }
+}
+
+static void
+delete_impl_graph (QRATPrePlus * qr, ImplGraph *g)
+{
+  mm_free (qr->mm, g->offsets, (g->num_nodes + 1) * sizeof (unsigned int));
+  mm_free (qr->mm, g->edges, (g->num_edges ? g->num_edges : 1) *
+           sizeof (unsigned int));
+}
+
+/* Returns nonzero iff literal 'l1' is a better representative of its
+   equivalence class than 'l2', i.e., from an outer qblock. */
+static int
+is_better_representative (QRATPrePlus * qr, LitID l1, LitID l2)
+{
+  Var *v1 = LIT2VARPTR (qr->pcnf.vars, l1);
+  Var *v2 = LIT2VARPTR (qr->pcnf.vars, l2);
+  if (v1->qblock->nesting != v2->qblock->nesting)
+    return v1->qblock->nesting < v2->qblock->nesting;
+  return v1->id < v2->id;
+}
+
+/* Set the substitutes of the variables in the strongly connected component
+   'nodes' with 'num' literals. All literals are replaced by the outermost
+   one, unless the component contains complementary literals or universal
+   literals other than the outermost one. */
+static void
+set_substitutes (QRATPrePlus * qr, unsigned int *nodes, unsigned int num,
+                 LitID *substitutes)
+{
+  if (num <= 1)
+    return;
+
+  LitID rep = NODE2LIT (nodes[0]);
+  unsigned int i;
+  for (i = 1; i < num; i++)
+    if (is_better_representative (qr, NODE2LIT (nodes[i]), rep))
+      rep = NODE2LIT (nodes[i]);
+
+  /* Complementary literals are equivalent if a variable is marked twice:
+     the formula is unsatisfiable, which we leave to the solver. */
+  int valid = 1;
+  for (i = 0; i < num; i++)
+    {
+      LitID lit = NODE2LIT (nodes[i]);
+      Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+      if ((lit != rep && var->qblock->type == QTYPE_FORALL) || var->mark0)
+        valid = 0;
+      var->mark0 = 1;
+    }
+  for (i = 0; i < num; i++)
+    LIT2VARPTR (qr->pcnf.vars, NODE2LIT (nodes[i]))->mark0 = 0;
+  if (!valid)
+    return;
+
+  for (i = 0; i < num; i++)
+    {
+      LitID lit = NODE2LIT (nodes[i]);
+      if (lit != rep)
+        substitutes[LIT2VARID (lit)] = LIT_NEG (lit) ? -rep : rep;
+    }
+}
+
+/* Find the strongly connected components of 'g' by Tarjan's algorithm,
+   implemented iteratively to avoid deep recursion on long chains of
+   implications, and set substitutes of variables. */
+static void
+find_equivalent_literals (QRATPrePlus * qr, ImplGraph *g, LitID *substitutes)
+{
+  const size_t bytes = g->num_nodes * sizeof (unsigned int);
+  unsigned int *index = mm_malloc (qr->mm, bytes);
+  unsigned int *low = mm_malloc (qr->mm, bytes);
+  /* Next successor to be visited of each node on the DFS stack. */
+  unsigned int *next_edge = mm_malloc (qr->mm, bytes);
+  unsigned int *dfs = mm_malloc (qr->mm, bytes);
+  unsigned int *scc = mm_malloc (qr->mm, bytes);
+  char *on_scc = mm_malloc (qr->mm, g->num_nodes);
+  memset (index, 0xff, bytes);
+  memset (on_scc, 0, g->num_nodes);
+
+  unsigned int root, cnt_index = 0, dfs_top = 0, scc_top = 0;
+  for (root = 0; root < g->num_nodes; root++)
+    {
+      if (index[root] != NODE_UNVISITED ||
+          g->offsets[root] == g->offsets[root + 1])
+        continue;
+
+      index[root] = low[root] = cnt_index++;
+      next_edge[root] = g->offsets[root];
+      dfs[dfs_top++] = root;
+      scc[scc_top++] = root;
+      on_scc[root] = 1;
+
+      while (dfs_top)
+        {
+          unsigned int v = dfs[dfs_top - 1];
+          if (next_edge[v] < g->offsets[v + 1])
+            {
+              unsigned int w = g->edges[next_edge[v]++];
+              if (index[w] == NODE_UNVISITED)
+                {
+                  index[w] = low[w] = cnt_index++;
+                  next_edge[w] = g->offsets[w];
+                  dfs[dfs_top++] = w;
+                  scc[scc_top++] = w;
+                  on_scc[w] = 1;
+                }
+              else if (on_scc[w] && index[w] < low[v])
+                low[v] = index[w];
+            }
+          else
+            {
+              dfs_top--;
+              if (low[v] == index[v])
+                {
+                  unsigned int start = scc_top;
+                  do
+                    on_scc[scc[--start]] = 0;
+                  while (scc[start] != v);
+                  set_substitutes (qr, scc + start, scc_top - start,
+                                   substitutes);
+                  scc_top = start;
+                }
+              if (dfs_top)
+                {
+                  unsigned int u = dfs[dfs_top - 1];
+                  if (low[v] < low[u])
+                    low[u] = low[v];
+                }
+            }
+        }
+    }
+
+  mm_free (qr->mm, index, bytes);
+  mm_free (qr->mm, low, bytes);
+  mm_free (qr->mm, next_edge, bytes);
+  mm_free (qr->mm, dfs, bytes);
+  mm_free (qr->mm, scc, bytes);
+  mm_free (qr->mm, on_scc, g->num_nodes);
+}
+
+/* Replace literals in all clauses according to 'substitutes' and rebuild
+   the occurrence stacks. Clauses that become tautological are deleted. */
+static void
+apply_substitutes (QRATPrePlus * qr, LitID *substitutes)
+{
+  reset_occurrences (qr);
+
+  Clause *c, *n;
+  for (c = qr->pcnf.clauses.first; c; c = n)
+    {
+      n = c->link.next;
+      assert (!c->redundant);
+      LitID *p, *e;
+      for (p = c->lits, e = p + c->num_lits; p < e; p++)
+        {
+          LitID subst = substitutes[LIT2VARID (*p)];
+          if (subst)
+            *p = LIT_NEG (*p) ? -subst : subst;
+        }
+      c->lw_index = c->rw_index = WATCHED_LIT_INVALID_INDEX;
+      if (reimport_clause (qr, c))
+        {
+          if (QRATPREPLUS_TRACE (qr))
+            fprintf (stderr, "Deleting clause ID %u, tautological after "
+                     "substitution.\n", c->id);
+          UNLINK (qr->pcnf.clauses, c, link);
+          mm_free (qr->mm, c, CLAUSE_BYTES (c->size_lits));
+          qr->cnt_els_deleted_clauses++;
+          qr->actual_num_clauses--;
+        }
+    }
+}
+
+/* -------------------- START: PUBLIC FUNCTIONS -------------------- */
+
+void
+substitute_equivalent_literals (QRATPrePlus * qr)
+{
+  double start = time_stamp ();
+  /* Clauses may have been found redundant by subsumption at import. */
+  unlink_redundant_clauses (qr);
+
+  ImplGraph g;
+  build_impl_graph (qr, &g);
+  LitID *substitutes = mm_malloc (qr->mm, qr->pcnf.size_vars * sizeof (LitID));
+  memset (substitutes, 0, qr->pcnf.size_vars * sizeof (LitID));
+  find_equivalent_literals (qr, &g, substitutes);
+  delete_impl_graph (qr, &g);
+
+  VarID v;
+  for (v = 0; v < qr->pcnf.size_vars; v++)
+    if (substitutes[v])
+      {
+        assert (qr->pcnf.vars[v].qblock->type == QTYPE_EXISTS);
+        assert (!substitutes[LIT2VARID (substitutes[v])]);
+        qr->cnt_els_substituted_vars++;
+      }
+
+  if (qr->cnt_els_substituted_vars)
+    apply_substitutes (qr, substitutes);
+  mm_free (qr->mm, substitutes, qr->pcnf.size_vars * sizeof (LitID));
+
+  if (qr->options.verbosity >= 1)
+    fprintf (stderr, "Substituted %u equivalent variables, deleted %u "
+             "clauses in %f sec\n", qr->cnt_els_substituted_vars,
+             qr->cnt_els_deleted_clauses, time_stamp () - start);
+}
+
+/* -------------------- END: PUBLIC FUNCTIONS -------------------- */
@@ -0,0 +1,35 @@
+/*
+ This file is part of QRATPre+.
+
+ Copyright 2019
+ Florian Lonsing, Stanford University, USA.
+
+ Copyright 2018
+ Florian Lonsing, Vienna University of Technology, Austria.
+
+ QRATPre+ is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or (at
+ your option) any later version.
+
+ QRATPre+ is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with QRATPre+.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef QRATPREPLUS_ELS_H_INCLUDED
+#define QRATPREPLUS_ELS_H_INCLUDED
+
+#include "qratpreplus_internals.h"
+
+/* Detect equivalent literals by strongly connected components in the
+   implication graph of binary clauses and replace every existential
+   literal by an equivalent literal from the same or an outer qblock. Clauses
+   found redundant so far are unlinked first. */
+void substitute_equivalent_literals (QRATPrePlus * qr);
+
+#endif
@@ -26,6 +26,7 @@
 #include "qratpreplus_internals.h"
 #include "util.h"
 #include "parse.h"
+#include "qbce_qrat_plus.h"
 
 /* Comparison function used to sort literals of clauses. */
 static int
@@ -52,11 +53,21 @@ compare_lits_by_nesting (QRATPrePlus * qr, LitID lit1, LitID lit2)
     }
 }
 
-/* Discard complementary literals or multiple literals of the same
-   variable. Returns nonzero iff clause is tautological and hence should be
-   discarded. */
+/* Set the nesting levels of the literals in 'c'. */
+static void
+set_clause_nestings (QRATPrePlus * qr, Clause * c)
+{
+  Nesting *np = CLAUSE_NESTINGS (c);
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    *np++ = LIT2VARPTR (qr->pcnf.vars, *p)->qblock->nesting;
+}
+
+/* Copy the parsed literals to 'clause' and discard complementary literals
+   or multiple literals of the same variable. Returns nonzero iff clause is
+   tautological and hence should be discarded. */
 static int
-check_and_add_clause (QRATPrePlus * qr, Clause * clause)
+copy_parsed_literals (QRATPrePlus * qr, Clause * clause)
 {
   int taut = 0;
   /* Add parsed literals to allocated clause object 'clause'. */
@@ -76,7 +87,7 @@ check_and_add_clause (QRATPrePlus * qr, Clause * clause)
         {
           if (LIT_POS (lit))
             {
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 fprintf (stderr, "literal %d appears multiple times in clause!\n", lit);
               /* Ignore multiple occurrences. */
               assert (clause->num_lits > 0);
@@ -86,7 +97,7 @@ check_and_add_clause (QRATPrePlus * qr, Clause * clause)
 
           if (LIT_NEG (lit))
             {
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 fprintf (stderr, "Clause has complementary literals!\n");
               taut = 1;
               break;
@@ -96,7 +107,7 @@ check_and_add_clause (QRATPrePlus * qr, Clause * clause)
         {
           if (LIT_NEG (lit))
             {
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 fprintf (stderr, "literal %d appears multiple times in clause!\n", lit);
               /* Ignore multiple occurrences. */
               assert (clause->num_lits > 0);
@@ -106,7 +117,7 @@ check_and_add_clause (QRATPrePlus * qr, Clause * clause)
 
           if (LIT_POS (lit))
             {
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 fprintf (stderr, "Clause has complementary literals!");
               taut = 1;
               break;
@@ -130,10 +141,15 @@ check_and_add_clause (QRATPrePlus * qr, Clause * clause)
   for (p = qr->parsed_literals.start, e = qr->parsed_literals.top; p < e; p++)
     VAR_UNMARK (LIT2VARPTR (qr->pcnf.vars, *p));
 
-  /* Return early if clause is tautological. */
-  if (taut)
-    return 1;
+  return taut;
+}
 
+/* Sort the literals of 'clause', reduce trailing universal literals, and
+   add the clause to the stacks of occurrences. */
+static void
+index_clause (QRATPrePlus * qr, Clause * clause)
+{
+  LitID *p, *e;
   /* Sort literals by nesting levels. */
   SORT (qr, LitID, compare_lits_by_nesting, clause->lits,
         clause->num_lits);
@@ -153,6 +169,8 @@ check_and_add_clause (QRATPrePlus * qr, Clause * clause)
         break;
     }
 
+  set_clause_nestings (qr, clause);
+
   if (clause->num_lits == 0)
     qr->parsed_empty_clause = 1;
   else if (clause->num_lits == 1)
@@ -179,14 +197,32 @@ check_and_add_clause (QRATPrePlus * qr, Clause * clause)
         }
     }
 
+  clause->sig = compute_signature (clause->lits, clause->lits + clause->num_lits);
+
   qr->total_clause_lengths += clause->num_lits;
   if (clause->num_lits > qr->max_clause_length)
     qr->max_clause_length = clause->num_lits;
+}
+
+/* Discard complementary literals or multiple literals of the same
+   variable. Returns nonzero iff clause is tautological and hence should be
+   discarded. */
+static int
+check_and_add_clause (QRATPrePlus * qr, Clause * clause)
+{
+  /* Return early if clause is tautological. */
+  if (copy_parsed_literals (qr, clause))
+    return 1;
+
+  index_clause (qr, clause);
   
   /* Append clause to list of clauses. */
   LINK_LAST (qr->pcnf.clauses, clause, link);
 
   qr->actual_num_clauses++;
+
+  if (qr->options.subsumption)
+    subsume_imported_clause (qr, clause);
   
   return 0;
 }
@@ -239,8 +275,7 @@ import_parsed_clause (QRATPrePlus * qr)
      literals on the stack 'parsed_literals' will be copied to the new clause
      object. */
   int num_lits = COUNT_STACK (qr->parsed_literals);
-  Clause *clause = mm_malloc (qr->mm, sizeof (Clause) +
-                              num_lits * sizeof (LitID));
+  Clause *clause = mm_malloc (qr->mm, CLAUSE_BYTES (num_lits));
   clause->id = ++qr->cur_clause_id;
   clause->num_lits = num_lits;
   clause->size_lits = num_lits;
@@ -254,7 +289,7 @@ import_parsed_clause (QRATPrePlus * qr)
     {
       init_watched_literals (qr, clause);
       
-      if (qr->options.verbosity >= 2)
+      if (QRATPREPLUS_TRACE (qr))
         {
           fprintf (stderr, "Imported clause: ");
           print_lits (qr, stderr, clause->lits, clause->num_lits, 1);
@@ -262,9 +297,9 @@ import_parsed_clause (QRATPrePlus * qr)
     }
   else
     {
-      if (qr->options.verbosity >= 2)
+      if (QRATPREPLUS_TRACE (qr))
         fprintf (stderr, "Deleting tautological clause.\n");
-      mm_free (qr->mm, clause, sizeof (Clause) + clause->size_lits * sizeof (LitID));
+      mm_free (qr->mm, clause, CLAUSE_BYTES (clause->size_lits));
     }
 }
 
@@ -311,6 +346,12 @@ update_qblock_nestings (QRATPrePlus * qr)
   QBlock *s;
   for (s = qr->pcnf.qblocks.first; s; s = s->link.next)
     s->nesting = nesting++;
+
+  /* Nesting levels of literals stored in clauses must be updated as well
+     (no clauses have been imported yet if called during parsing). */
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    set_clause_nestings (qr, c);
 }
 
 #define PARSER_READ_NUM(num, c)                        \
@@ -345,6 +386,43 @@ update_qblock_nestings (QRATPrePlus * qr)
 
 /* -------------------- START: PUBLIC FUNCTIONS -------------------- */
 
+int
+reimport_clause (QRATPrePlus * qr, Clause * c)
+{
+  assert (c->lw_index == WATCHED_LIT_INVALID_INDEX);
+  assert (c->rw_index == WATCHED_LIT_INVALID_INDEX);
+  RESET_STACK (qr->parsed_literals);
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    PUSH_STACK (qr->mm, qr->parsed_literals, *p);
+  int taut = copy_parsed_literals (qr, c);
+  RESET_STACK (qr->parsed_literals);
+  if (taut)
+    return 1;
+  index_clause (qr, c);
+  init_watched_literals (qr, c);
+  return 0;
+}
+
+void
+reset_occurrences (QRATPrePlus * qr)
+{
+  Var *var, *vars_end;
+  for (var = qr->pcnf.vars, vars_end = var + qr->pcnf.size_vars;
+       var < vars_end; var++)
+    {
+      RESET_STACK (var->neg_occ_clauses);
+      RESET_STACK (var->pos_occ_clauses);
+      RESET_STACK (var->watched_neg_occ_clauses);
+      RESET_STACK (var->watched_pos_occ_clauses);
+      var->cnt_stale_neg_occs = var->cnt_stale_pos_occs = 0;
+      var->cnt_redundant_watched = 0;
+    }
+  RESET_STACK (qr->unit_input_clauses);
+  qr->total_occ_cnts = 0;
+  qr->total_clause_lengths = 0;
+}
+
 /* Merge and remove adjacent qblocks of the same quantifier type. */
 void
 merge_adjacent_same_type_qblocks (QRATPrePlus * qr, int update_nestings)
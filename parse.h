@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include "qratpreplus.h"
+#include "qratpreplus_internals.h"
 
 /* Merge and remove adjacent qblocks of the same quantifier type. */
 void merge_adjacent_same_type_qblocks (QRATPrePlus * qr, int update_nestings);
@@ -47,4 +48,15 @@ void open_new_qblock (QRATPrePlus *, int);
    in the formula, then the program aborts. */
 void set_up_var_table (QRATPrePlus *, int);
 
+/* Add clause 'c', whose literals were modified after parsing, to the
+   stacks of occurrences and watched occurrences again, like a parsed
+   clause. 'c' must not be on any of these stacks. Returns nonzero iff 'c'
+   is tautological, in which case it is not added. */
+int reimport_clause (QRATPrePlus * qr, Clause * c);
+
+/* Clear the stacks of occurrences and watched occurrences and the related
+   counters of all variables, such that all clauses can be reimported by
+   'reimport_clause'. */
+void reset_occurrences (QRATPrePlus * qr);
+
 #endif
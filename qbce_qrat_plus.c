@@ -23,6 +23,8 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 #include "stack.h"
 #include "qbcp.h"
 #include "util.h"
@@ -39,6 +41,34 @@ enum QRATPlusCheckMode
 
 typedef enum QRATPlusCheckMode QRATPlusCheckMode;
 
+/* Techniques applied to clauses in the unified priority schedule. */
+enum QRATPlusTechnique
+{
+  QRATPLUS_TECHNIQUE_QBCE = 0,
+  QRATPLUS_TECHNIQUE_AT = 1,
+  QRATPLUS_TECHNIQUE_QRATE = 2,
+  QRATPLUS_TECHNIQUE_BLE = 3,
+  QRATPLUS_TECHNIQUE_QRATU = 4,
+  QRATPLUS_NUM_TECHNIQUES = 5
+};
+
+typedef enum QRATPlusTechnique QRATPlusTechnique;
+
+#define QRATPLUS_TECHNIQUE_BIT(t) (1u << (t))
+#define QRATPLUS_CLAUSE_TECHNIQUES                                 \
+  (QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QBCE) |              \
+   QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_AT) |                \
+   QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QRATE))
+#define QRATPLUS_LITERAL_TECHNIQUES                                \
+  (QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_BLE) |               \
+   QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QRATU))
+#define QRATPLUS_ALL_TECHNIQUES                                    \
+  (QRATPLUS_CLAUSE_TECHNIQUES | QRATPLUS_LITERAL_TECHNIQUES)
+
+/* In the priority schedule, the cost of a QBCP call relative to the cost
+   of checking a single resolvent for a tautology. */
+#define QRATPLUS_PRIORITY_QBCP_COST 32
+
 /* Check if soft time limit is exceeded every
    '2^QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD' clause checks. With small
    values the accuracy of the time limit will be higher but checking
@@ -47,57 +77,181 @@ typedef enum QRATPlusCheckMode QRATPlusCheckMode;
    expensive. */
 #define QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD 10
 
+/* In parallel QBCE, worker threads fetch chunks of
+   'QRATPLUS_WORKER_CHUNK_SIZE' clauses from the shared list of clauses to
+   be checked. Small chunks balance the load better, large chunks reduce
+   contention on the shared cursor. Since QRAT and AT checks are much more
+   expensive than QBCE checks, smaller chunks of size
+   'QRATPLUS_SPECULATIVE_CHUNK_SIZE' are used in speculative checking. */
+#define QRATPLUS_WORKER_CHUNK_SIZE 64
+#define QRATPLUS_SPECULATIVE_CHUNK_SIZE 4
+
+/* In speculative QRATE and AT, clauses are checked by the workers in
+   windows of 'QRATPLUS_SPECULATION_WINDOW' clauses. The results of a window
+   are committed before the next window is checked. With large windows,
+   results are more likely to be invalidated by clauses found redundant
+   earlier in the same window. In speculative QRATU, the window is halved
+   after each clause from which literals were removed and doubled after a
+   window without removals, but it never drops below
+   'QRATPLUS_SPECULATIVE_CHUNK_SIZE' clauses per worker. */
+#define QRATPLUS_SPECULATION_WINDOW 1024
+
+typedef struct Worker Worker;
+
+/* Result of a speculative QRAT, AT, or QRATU check of a clause by a
+   worker. The IDs of witness clauses collected and of clauses used in the
+   check are stored on stacks 'witness_ids' and 'used_ids' of the worker,
+   and literals found redundant in QRATU on stack 'removed_lits'. */
+typedef struct CheckResult CheckResult;
+struct CheckResult
+{
+  Worker *worker;
+  unsigned int checked:1;
+  unsigned int redundant:1;
+  /* Clause has a pivot with many occurrences and is checked by the main
+     thread with all workers (see 'has_qrat_on_literal_parallel'). */
+  unsigned int deferred:1;
+  unsigned int witnesses_start;
+  unsigned int witnesses_end;
+  unsigned int used_start;
+  unsigned int used_end;
+  unsigned int removed_start;
+  unsigned int removed_end;
+};
+
+/* Clauses to be checked in an iteration of parallel QBCE or in a window of
+   speculative QRATE, AT, and QRATU. Shared by all workers, which claim chunks of
+   clauses by atomically advancing 'next'. */
+typedef struct WorkList WorkList;
+struct WorkList
+{
+  Clause **clauses;
+  unsigned int cnt;
+  unsigned int next;
+  unsigned int chunk_size;
+  /* Set by the first worker that exceeds the soft time limit. */
+  int exceeded;
+  /* Speculative checking only: check mode and results of checks, indexed
+     like 'clauses'. */
+  QRATPlusCheckMode mode;
+  CheckResult *results;
+  /* Speculative checking only: clauses of the shared formula indexed by
+     ID. */
+  Clause **clauses_by_id;
+  /* Parallel check of outer resolvents only: clause 'clause' is checked on
+     pivot 'lit' with the occurrences in 'clauses'. Index of first
+     occurrence found to produce an outer resolvent that is not AT, or
+     'cnt' if no such occurrence was found yet. */
+  Clause *clause;
+  LitID lit;
+  unsigned int first_failed;
+};
+
+/* Worker in parallel QBCE and speculative QRATE, AT, and QRATU. Each worker has a
+   private copy 'qr' of the preprocessor object with its own memory manager,
+   witness stack, and statistics. In QBCE, the formula is shared and
+   read-only while workers are running. Since QBCP modifies assignments and
+   watched literals, workers in speculative checking have a private copy of
+   the formula in 'qr->pcnf'. */
+struct Worker
+{
+  QRATPrePlus qr;
+  pthread_t thread;
+  unsigned int thread_started:1;
+  WorkList *work;
+  /* Clauses found blocked by this worker in the current iteration. */
+  ClausePtrStack redundant;
+  /* Speculative checking only: copies of clauses indexed by ID, where
+     clauses that were redundant when copying the formula are null. */
+  Clause **clones;
+  /* Speculative checking only: number of clauses on
+     'qr->redundant_clauses' of the shared formula that have been marked
+     redundant in the copy of the formula. */
+  unsigned int synced_redundant;
+  /* Speculative checking only: see 'CheckResult'. */
+  ClauseIDStack witness_ids;
+  ClauseIDStack used_ids;
+  LitIDStack removed_lits;
+};
+
 /* Returns non-zero iff clause 'c' contains at least one literal of a
    variable that appears in the outermost (i.e. leftmost) quantifier
    block. */
 static int
 clause_has_outermost_qblock_literal (QRATPrePlus * qr, Clause *c)
 {
-  LitID *p, *e;
-  for (p = c->lits, e = p + c->num_lits; p < e; p++)
-    {
-      LitID lit = *p;
-      Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
-      if (var->qblock->nesting == 0)
-        return 1;
-    }
-  return 0;
+  /* Literals are sorted by qblock ordering. */
+  return c->num_lits && CLAUSE_NESTINGS (c)[0] == 0;
+}
+
+/* Returns the number of clauses on occurrences 'occs' of variable 'var'
+   without stale entries. */
+static unsigned int
+count_occs (Var *var, ClausePtrStack *occs)
+{
+  return COUNT_STACK (*occs) - (occs == &var->neg_occ_clauses ?
+                                var->cnt_stale_neg_occs :
+                                var->cnt_stale_pos_occs);
 }
 
-/* Returns true if and only if 'lit' appears in the literal array
-   bounded by 'start' and 'end' (position 'end' is not part of the
-   array) AND 'lit' is from a qblock of nesting level equal to
-   'nesting' or smaller. Assumes that literal array is sorted by qblock
-   ordering. */
+/* Returns nonzero iff 'occ' on the occurrences of literal 'lit' is a stale
+   entry, i.e., 'lit' was removed from 'occ'. */
 static int
-find_literal_outer_tautology (QRATPrePlus * qr, LitID taut_lit, Nesting nesting,
-                              LitID * start, LitID * end)
+is_stale_occ (QRATPrePlus * qr, Clause *occ, LitID lit)
+{
+  Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+  if (!(LIT_NEG (lit) ? var->cnt_stale_neg_occs : var->cnt_stale_pos_occs))
+    return 0;
+  return !(occ->sig & LIT2SIG (lit)) ||
+    !find_literal (lit, occ->lits, occ->lits + occ->num_lits);
+}
+
+/* Returns the signature of all literals in 'c' except 'lit' which are
+   from a qblock smaller than or equal to the qblock of 'lit'. Only these
+   literals may produce an outer tautology in the resolvent on 'lit'. */
+static ClauseSig
+get_outer_signature (QRATPrePlus * qr, Clause *c, LitID lit)
 {
-  LitID *p;
-  for (p = start; p < end; p++)
+  Nesting nesting = LIT2VARPTR (qr->pcnf.vars, lit)->qblock->nesting;
+  ClauseSig result = 0;
+  LitID *p, *e;
+  for (p = c->lits, e = p + get_nesting_cutoff (c, nesting); p < e; p++)
     {
-      LitID lit = *p;
-      Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
-      if (var->qblock->nesting > nesting)
-        break;
-      if (lit == taut_lit)
-        return 1;
+      LitID cl = *p;
+      if (cl != lit)
+        result |= LIT2SIG (cl);
     }
-  return 0;
+  return result;
 }
 
 /* Return nonzero iff resolvent of 'c' and 'occ' on literal 'lit' is
    tautologous with respect to a variable that is smaller than or
-   equal to 'lit' in the prefix ordering. */
-static int
-check_outer_tautology (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ)
+   equal to 'lit' in the prefix ordering. Signature 'c_outer_sig' must be
+   the signature of 'c' as returned by 'get_outer_signature'. Parameters
+   'by_nesting' and 'propositional' stand for option
+   'qbce_check_taut_by_nesting' and 'qr->propositional' and are constant in
+   the kernels below. */
+static QRATPREPLUS_KERNEL_INLINE int
+check_outer_tautology_aux (QRATPrePlus * qr, Clause *c, LitID lit,
+                           Clause *occ, ClauseSig c_outer_sig,
+                           const int by_nesting, const int propositional)
 {
   assert (!c->redundant);
   assert (!occ->redundant);
   assert (c->num_lits > 0);
   assert (occ->num_lits > 0);
+  assert (c_outer_sig == get_outer_signature (qr, c, lit));
+  assert (occ->sig == compute_signature (occ->lits, occ->lits + occ->num_lits));
 
   qr->clause_redundancy_or_checks++;
+
+  /* Resolvent cannot be tautologous if no literal in the outer part of 'c'
+     has its complement in 'occ'. */
+  if (!(c_outer_sig & SIG_COMPLEMENT (occ->sig)))
+    {
+      qr->clause_redundancy_or_checks_sig_filtered++;
+      return 0;
+    }
   
   Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
   QBlock *qblock = var->qblock;
@@ -107,18 +261,37 @@ check_outer_tautology (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ)
   assert (find_literal (lit, c->lits, c->lits + c->num_lits));
   assert (find_literal (-lit, occ->lits, occ->lits + occ->num_lits));
 
-  const unsigned int qbce_check_taut_by_nesting =
-    qr->options.qbce_check_taut_by_nesting;
-  
   LitID *cp, *ce;
-  for (cp = c->lits, ce = cp + c->num_lits; cp < ce; cp++)
+  /* All literals are from the same qblock and nesting levels need not be
+     looked up. */
+  if (propositional)
+    {
+      assert (qr->propositional);
+      LitID *occ_lits_end = occ->lits + occ->num_lits;
+      for (cp = c->lits, ce = cp + c->num_lits; cp < ce; cp++)
+        {
+          qr->clause_redundancy_or_checks_lits_seen++;
+          LitID cl = *cp;
+          if (cl != lit && find_literal (-cl, occ->lits, occ_lits_end))
+            return 1;
+        }
+      return 0;
+    }
+
+  assert (by_nesting == qr->options.qbce_check_taut_by_nesting);
+
+  /* Exploit qblock ordering of literals: if enabled, then ignore literals
+     from qblocks larger than 'lit' in both 'c' and 'occ'. The end of these
+     prefixes is looked up in the arrays of nesting levels. */
+  LitID *occ_end = occ->lits + (by_nesting ?
+                                get_nesting_cutoff (occ, nesting) : occ->num_lits);
+  Nesting *c_nestings = CLAUSE_NESTINGS (c);
+  for (cp = c->lits, ce = cp + (by_nesting ?
+                                get_nesting_cutoff (c, nesting) : c->num_lits);
+       cp < ce; cp++)
     {
       qr->clause_redundancy_or_checks_lits_seen++;
       LitID cl = *cp;
-      Var *cv = LIT2VARPTR (qr->pcnf.vars, cl);
-      /* Can ignore variables from qblocks larger than 'lit'. */
-      if (qbce_check_taut_by_nesting && cv->qblock->nesting > nesting)
-        break;
       /* Must ignore potential blocking literal 'lit'. */
       if (cl != lit)
         {
@@ -126,17 +299,470 @@ check_outer_tautology (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ)
              nesting level smaller than or equal to nesting of
              'lit'. Check whether other clause 'occ' contains
              complementary literal '-cl'. */
-
-          if ((!qbce_check_taut_by_nesting && (cv->qblock->nesting <= nesting)
-               && find_literal (-cl, occ->lits, occ->lits + occ->num_lits)) ||
-              (qbce_check_taut_by_nesting && find_literal_outer_tautology
-               (qr, -cl, nesting, occ->lits, occ->lits + occ->num_lits)))
+          if (c_nestings[cp - c->lits] <= nesting &&
+              find_literal (-cl, occ->lits, occ_end))
             return 1;
         }
     }
   return 0;
 }
 
+/* Instances of 'check_outer_tautology_aux' for the option
+   'qbce_check_taut_by_nesting' and for propositional formulas, selected
+   by 'select_outer_tautology_kernel'. */
+#define DEFINE_OUTER_TAUTOLOGY_KERNEL(name, by_nesting, propositional)   \
+  static int                                                            \
+  name (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ,            \
+        ClauseSig c_outer_sig)                                          \
+  {                                                                     \
+    return check_outer_tautology_aux (qr, c, lit, occ, c_outer_sig,     \
+                                      by_nesting, propositional);       \
+  }
+
+DEFINE_OUTER_TAUTOLOGY_KERNEL (check_outer_tautology_by_nesting, 1, 0)
+DEFINE_OUTER_TAUTOLOGY_KERNEL (check_outer_tautology_all_lits, 0, 0)
+DEFINE_OUTER_TAUTOLOGY_KERNEL (check_outer_tautology_propositional, 0, 1)
+
+/* Statistics accumulated by workers and added to the statistics of the
+   main object after parallel or speculative clause checks. */
+#define WORKER_STATS(STAT)                              \
+  STAT (cnt_qbce_checks)                                \
+  STAT (cnt_qratu_checks)                               \
+  STAT (qrat_qbcp_checks)                               \
+  STAT (limit_qbcp_cur_props_reached)                   \
+  STAT (qbcp_total_props)                               \
+  STAT (qbcp_successful_checks_props)                   \
+  STAT (qrat_qbcp_successful_checks)                    \
+  STAT (total_assignments)                              \
+  STAT (qbcp_total_eabs_nestings)                       \
+  STAT (qbcp_total_calls)                               \
+  STAT (clause_redundancy_or_checks)                    \
+  STAT (clause_redundancy_or_checks_lits_seen)          \
+  STAT (clause_redundancy_or_checks_sig_filtered)     \
+  STAT (cnt_pivots_over_occ_limit)                      \
+  STAT (cnt_resolvent_limit_reached)                    \
+  STAT (cnt_witness_positions)                          \
+  STAT (sum_witness_positions)
+
+/* Add statistics of worker 'w' to 'qr' and reset them in 'w'. */
+static void
+merge_worker_stats (QRATPrePlus * qr, Worker *w)
+{
+  /* Propagations of the last QBCP call of the worker are not yet counted. */
+  w->qr.qbcp_total_props += w->qr.qbcp_cur_props;
+  w->qr.qbcp_cur_props = 0;
+#define MERGE_STAT(member)                      \
+  qr->member += w->qr.member;                   \
+  w->qr.member = 0;
+  WORKER_STATS (MERGE_STAT)
+#undef MERGE_STAT
+}
+
+static ClausePtrStack *
+get_occs (Var *var, int neg, int watched)
+{
+  if (watched)
+    return neg ? &var->watched_neg_occ_clauses : &var->watched_pos_occ_clauses;
+  else
+    return neg ? &var->neg_occ_clauses : &var->pos_occ_clauses;
+}
+
+/* Copy the non-redundant clauses of the formula of 'qr' including
+   occurrence lists, watched literals and unit input clauses to worker
+   'w'. Quantifier blocks are shared. The order of all lists is preserved,
+   hence clause checks on the copy visit clauses in the same order. */
+static void
+clone_formula (QRATPrePlus * qr, Worker *w)
+{
+  QRATPrePlus *wqr = &w->qr;
+  w->clones = mm_malloc (wqr->mm, (qr->cur_clause_id + 1) * sizeof (Clause *));
+  w->synced_redundant = COUNT_STACK (qr->redundant_clauses);
+
+  memset (&wqr->pcnf.clauses, 0, sizeof (wqr->pcnf.clauses));
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    if (!c->redundant)
+      {
+        assert (c->id <= qr->cur_clause_id);
+        assert (!c->witness && !c->mark && !c->lw_update_collected);
+        Clause *clone = mm_malloc (wqr->mm, CLAUSE_BYTES (c->size_lits));
+        memcpy (clone, c, CLAUSE_BYTES (c->size_lits));
+        clone->rescheduled = 0;
+        clone->link.prev = clone->link.next = 0;
+        LINK_LAST (wqr->pcnf.clauses, clone, link);
+        w->clones[c->id] = clone;
+      }
+
+  wqr->pcnf.vars = mm_malloc (wqr->mm, qr->pcnf.size_vars * sizeof (Var));
+  Var *v, *ve, *wv;
+  for (v = qr->pcnf.vars, ve = v + qr->pcnf.size_vars, wv = wqr->pcnf.vars;
+       v < ve; v++, wv++)
+    {
+      *wv = *v;
+      wv->dirty = 0;
+      wv->cnt_redundant_watched = 0;
+      wv->cnt_stale_neg_occs = wv->cnt_stale_pos_occs = 0;
+      unsigned int neg, watched;
+      for (neg = 0; neg <= 1; neg++)
+        for (watched = 0; watched <= 1; watched++)
+          {
+            ClausePtrStack *occs = get_occs (v, neg, watched);
+            ClausePtrStack *woccs = get_occs (wv, neg, watched);
+            LitID lit = neg ? -(LitID) v->id : (LitID) v->id;
+            INIT_STACK (*woccs);
+            Clause **cp, **ce;
+            for (cp = occs->start, ce = occs->top; cp < ce; cp++)
+              if (!(*cp)->redundant &&
+                  (watched || !is_stale_occ (qr, *cp, lit)))
+                PUSH_STACK (wqr->mm, *woccs, w->clones[(*cp)->id]);
+          }
+    }
+
+  INIT_STACK (wqr->unit_input_clauses);
+  Clause **cp, **ce;
+  for (cp = qr->unit_input_clauses.start, ce = qr->unit_input_clauses.top;
+       cp < ce; cp++)
+    if (!(*cp)->redundant)
+      PUSH_STACK (wqr->mm, wqr->unit_input_clauses, w->clones[(*cp)->id]);
+  INIT_STACK (wqr->qbcp_queue);
+  INIT_STACK (wqr->lw_update_clauses);
+  INIT_STACK (wqr->used_clauses);
+  INIT_STACK (wqr->redundant_clauses);
+}
+
+static void
+delete_formula_clone (QRATPrePlus * qr, Worker *w)
+{
+  QRATPrePlus *wqr = &w->qr;
+  Var *wv, *wve;
+  for (wv = wqr->pcnf.vars, wve = wv + wqr->pcnf.size_vars; wv < wve; wv++)
+    {
+      DELETE_STACK (wqr->mm, wv->neg_occ_clauses);
+      DELETE_STACK (wqr->mm, wv->pos_occ_clauses);
+      DELETE_STACK (wqr->mm, wv->watched_neg_occ_clauses);
+      DELETE_STACK (wqr->mm, wv->watched_pos_occ_clauses);
+    }
+  mm_free (wqr->mm, wqr->pcnf.vars, wqr->pcnf.size_vars * sizeof (Var));
+  Clause *c, *n;
+  for (c = wqr->pcnf.clauses.first; c; c = n)
+    {
+      n = c->link.next;
+      mm_free (wqr->mm, c, CLAUSE_BYTES (c->size_lits));
+    }
+  mm_free (wqr->mm, w->clones, (qr->cur_clause_id + 1) * sizeof (Clause *));
+  DELETE_STACK (wqr->mm, wqr->unit_input_clauses);
+  DELETE_STACK (wqr->mm, wqr->qbcp_queue);
+  DELETE_STACK (wqr->mm, wqr->lw_update_clauses);
+  DELETE_STACK (wqr->mm, wqr->used_clauses);
+  DELETE_STACK (wqr->mm, wqr->redundant_clauses);
+  DELETE_STACK (wqr->mm, w->witness_ids);
+  DELETE_STACK (wqr->mm, w->used_ids);
+  DELETE_STACK (wqr->mm, w->removed_lits);
+}
+
+/* Mark the copies of clauses that were found redundant since the last call
+   as redundant in the formula of worker 'w'. */
+static void
+sync_formula_clone (QRATPrePlus * qr, Worker *w)
+{
+  Clause **cp, **ce;
+  for (cp = qr->redundant_clauses.start + w->synced_redundant,
+         ce = qr->redundant_clauses.top; cp < ce; cp++)
+    {
+      Clause *clone = w->clones[(*cp)->id];
+      if (clone)
+        clone->redundant = 1;
+    }
+  w->synced_redundant = COUNT_STACK (qr->redundant_clauses);
+}
+
+/* Create workers for parallel QBCE or, if 'speculative' is nonzero, for
+   speculative QRATE, AT, or QRATU. */
+static Worker *
+create_workers (QRATPrePlus * qr, WorkList *work, int speculative)
+{
+  unsigned int i, num_workers = qr->options.threads;
+  Worker *workers = mm_malloc (qr->mm, num_workers * sizeof (Worker));
+  for (i = 0; i < num_workers; i++)
+    {
+      Worker *w = workers + i;
+      w->qr = *qr;
+      w->qr.mm = mm_create ();
+      w->qr.is_worker = 1;
+      w->qr.options.verbosity = 0;
+      INIT_STACK (w->qr.witness_clauses);
+      INIT_STACK (w->qr.dirty_vars);
+      /* Workers do not use the propagation cache of 'qr'. */
+      w->qr.prop_cache = 0;
+      w->qr.size_prop_cache = w->qr.cnt_prop_cache = 0;
+      INIT_STACK (w->qr.prop_cache_lits);
+      /* Statistics are accumulated per worker and then added to 'qr'. */
+#define RESET_STAT(member) w->qr.member = 0;
+      WORKER_STATS (RESET_STAT)
+#undef RESET_STAT
+      w->qr.qbcp_cur_props = 0;
+      w->qr.workers = 0;
+      w->work = work;
+      INIT_STACK (w->redundant);
+      if (speculative)
+        clone_formula (qr, w);
+    }
+  return workers;
+}
+
+static void
+delete_workers (QRATPrePlus * qr, Worker *workers)
+{
+  unsigned int i, num_workers = qr->options.threads;
+  for (i = 0; i < num_workers; i++)
+    {
+      Worker *w = workers + i;
+      if (w->clones)
+        delete_formula_clone (qr, w);
+      DELETE_STACK (w->qr.mm, w->qr.witness_clauses);
+      DELETE_STACK (w->qr.mm, w->qr.dirty_vars);
+      DELETE_STACK (w->qr.mm, w->redundant);
+      mm_delete (w->qr.mm);
+    }
+  mm_free (qr->mm, workers, num_workers * sizeof (Worker));
+}
+
+/* Claim the next chunk of clauses from 'work'. Returns nonzero iff a
+   non-empty chunk with indices from 'start' to 'end' (exclusive) was
+   claimed. */
+static int
+claim_chunk (WorkList *work, unsigned int *start, unsigned int *end)
+{
+  if (__atomic_load_n (&work->exceeded, __ATOMIC_RELAXED))
+    return 0;
+  unsigned int i = __atomic_fetch_add (&work->next, work->chunk_size,
+                                       __ATOMIC_RELAXED);
+  if (i >= work->cnt)
+    return 0;
+  *start = i;
+  *end = work->cnt - i < work->chunk_size ? work->cnt : i + work->chunk_size;
+  return 1;
+}
+
+/* Count clause check of worker in 'cnt_checks' and periodically check if
+   the soft time limit has been exceeded. If so, then notify all other
+   workers and return nonzero. */
+static int
+worker_exceeded_soft_time_limit (QRATPrePlus * qr, WorkList *work,
+                                 long long unsigned int *cnt_checks)
+{
+  (*cnt_checks)++;
+  if ((*cnt_checks &
+       ((1 << QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD) - 1)) == 0 &&
+      exceeded_soft_time_limit (qr))
+    {
+      __atomic_store_n (&work->exceeded, 1, __ATOMIC_RELAXED);
+      return 1;
+    }
+  return 0;
+}
+
+/* Run all workers on 'work', where worker 0 runs in the calling thread. If a
+   thread cannot be created, then the remaining workers take over its share
+   of the work. */
+static void
+run_workers (QRATPrePlus * qr, Worker *workers, void *(*run) (void *))
+{
+  unsigned int i, num_workers = qr->options.threads;
+  for (i = 1; i < num_workers; i++)
+    workers[i].thread_started =
+      !pthread_create (&workers[i].thread, 0, run, workers + i);
+  run (workers);
+  for (i = 1; i < num_workers; i++)
+    if (workers[i].thread_started)
+      pthread_join (workers[i].thread, 0);
+}
+
+/* Collect 'occ' as a witness for non-redundancy of 'c'. Worker threads
+   must not modify shared clauses, hence they collect witnesses on their
+   private stack without marking them. Duplicates are filtered out when the
+   worker's witnesses are merged (see 'merge_worker_results'). */
+static void
+collect_witness_clause (QRATPrePlus * qr, Clause *c, Clause *occ)
+{
+  if (qr->is_worker)
+    PUSH_STACK (qr->mm, qr->witness_clauses, occ);
+  else if (!occ->witness)
+    {
+      if (QRATPREPLUS_TRACE (qr))
+        {
+          fprintf (stderr, "  clause ");
+          print_lits (qr, stderr, occ->lits, occ->num_lits, 1);
+          fprintf (stderr, "    is witness of: ");
+          print_lits (qr, stderr, c->lits, c->num_lits, 1);
+        }
+      occ->witness = 1;
+      PUSH_STACK (qr->mm, qr->witness_clauses, occ);
+    }
+}
+
+static void
+reset_used_clauses (QRATPrePlus * qr)
+{
+  Clause **cp, **ce;
+  for (cp = qr->used_clauses.start, ce = qr->used_clauses.top; cp < ce; cp++)
+    {
+      assert ((*cp)->mark);
+      (*cp)->mark = 0;
+    }
+  RESET_STACK (qr->used_clauses);
+}
+
+/* Returns nonzero iff pivot with complementary occurrences 'comp_occs' must
+   be skipped due to the occurrence limit. */
+static int
+is_pivot_over_occ_limit (QRATPrePlus * qr, Var *var, ClausePtrStack *comp_occs)
+{
+  if (qr->options.per_pivot_occ_limit &&
+      count_occs (var, comp_occs) > qr->limit_max_occ_cnt)
+    {
+      qr->cnt_pivots_over_occ_limit++;
+      return 1;
+    }
+  return 0;
+}
+
+/* Returns nonzero iff the limit on outer resolvents of the current clause
+   check is reached. Otherwise, counts one more outer resolvent. */
+static int
+is_resolvent_limit_reached (QRATPrePlus * qr)
+{
+  if (qr->cur_resolvents++ < qr->limit_max_resolvents)
+    return 0;
+  if (qr->cur_resolvents == (long long unsigned int) qr->limit_max_resolvents + 1)
+    qr->cnt_resolvent_limit_reached++;
+  return 1;
+}
+
+/* Record that the occurrence at 'occ_p' on 'comp_occs' is a witness found
+   after checking 'pos' other occurrences. With move-to-front ordering, the
+   witness is moved to the front of 'comp_occs'. Worker threads may share
+   occurrences and hence do not reorder them. */
+static void
+record_witness_position (QRATPrePlus * qr, ClausePtrStack *comp_occs,
+                         Clause **occ_p, unsigned int pos)
+{
+  qr->cnt_witness_positions++;
+  qr->sum_witness_positions += pos;
+  if (qr->options.occ_order == OCC_ORDER_MTF && !qr->is_worker)
+    {
+      Clause *occ = *occ_p;
+      for (; occ_p > comp_occs->start; occ_p--)
+        *occ_p = *(occ_p - 1);
+      *occ_p = occ;
+    }
+}
+
+/* Thread function of a worker: check outer resolvents of 'work->clause' on
+   pivot 'work->lit' with occurrences claimed from the shared work
+   list. Occurrences after the first failing one found so far are skipped,
+   but all occurrences before it are checked. */
+static void *
+run_occ_split_worker (void *arg)
+{
+  Worker *w = (Worker *) arg;
+  QRATPrePlus *qr = &w->qr;
+  WorkList *work = w->work;
+  Clause *c = w->clones[work->clause->id];
+  unsigned int i, e;
+  while (claim_chunk (work, &i, &e))
+    for (; i < e && i < __atomic_load_n (&work->first_failed, __ATOMIC_RELAXED);
+         i++)
+      {
+        Clause *occ = w->clones[work->clauses[i]->id];
+        if (!occ || occ->redundant)
+          continue;
+        qr->clause_redundancy_or_checks++;
+        qr->clause_redundancy_or_checks_lits_seen += occ->num_lits;
+        int failed = !qrat_qbcp_check (qr, c, work->lit, occ);
+        reset_used_clauses (qr);
+        if (failed)
+          {
+            unsigned int cur = __atomic_load_n (&work->first_failed,
+                                                __ATOMIC_RELAXED);
+            while (i < cur &&
+                   !__atomic_compare_exchange_n (&work->first_failed, &cur, i,
+                                                 1, __ATOMIC_RELAXED,
+                                                 __ATOMIC_RELAXED))
+              ;
+            break;
+          }
+      }
+  return 0;
+}
+
+/* Like 'has_qrat_on_literal' but check the outer resolvents with the
+   occurrences on 'comp_occs' in parallel using the workers in
+   'qr->workers'. The first failing occurrence is the same as in sequential
+   checking, hence so is the collected witness. */
+static int
+has_qrat_on_literal_parallel (QRATPrePlus * qr, Clause *c, LitID lit,
+                              ClausePtrStack *comp_occs)
+{
+  unsigned int i, num_workers = qr->options.threads;
+  Worker *workers = qr->workers;
+  WorkList *saved_work = workers[0].work;
+  WorkList work;
+  memset (&work, 0, sizeof (work));
+  work.clauses = comp_occs->start;
+  work.cnt = work.first_failed = COUNT_STACK (*comp_occs);
+  work.chunk_size = QRATPLUS_SPECULATIVE_CHUNK_SIZE;
+  work.clause = c;
+  work.lit = lit;
+
+  qr->cnt_split_occ_checks++;
+  for (i = 0; i < num_workers; i++)
+    {
+      sync_formula_clone (qr, workers + i);
+      workers[i].work = &work;
+    }
+  run_workers (qr, workers, run_occ_split_worker);
+  for (i = 0; i < num_workers; i++)
+    {
+      workers[i].work = saved_work;
+      merge_worker_stats (qr, workers + i);
+    }
+
+  if (work.first_failed == work.cnt)
+    return 1;
+  /* Collect 'occ' as a witness for non-redundancy of 'c' (on 'lit'). */
+  if (LIT2VARPTR (qr->pcnf.vars, lit)->qblock->type == QTYPE_EXISTS)
+    collect_witness_clause (qr, c, comp_occs->start[work.first_failed]);
+  /* Position of the witness among the occurrences checked in sequential
+     checking, i.e., not counting redundant ones. */
+  unsigned int pos = 0;
+  for (i = 0; i < work.first_failed; i++)
+    if (!comp_occs->start[i]->redundant)
+      pos++;
+  record_witness_position (qr, comp_occs, comp_occs->start + work.first_failed,
+                           pos);
+  return 0;
+}
+
+/* Returns nonzero iff 'c' should be checked for QRAT by checking outer
+   resolvents in parallel, i.e., if one of its pivots has more occurrences
+   than 'split_occs_threshold'. */
+static int
+has_clause_high_occ_pivot (QRATPrePlus * qr, Clause *c)
+{
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    {
+      Var *var = LIT2VARPTR (qr->pcnf.vars, *p);
+      ClausePtrStack *comp_occs = LIT_NEG (*p) ?
+        &(var->pos_occ_clauses) : &(var->neg_occ_clauses);
+      if (var->qblock->type == QTYPE_EXISTS &&
+          count_occs (var, comp_occs) > qr->options.split_occs_threshold)
+        return 1;
+    }
+  return 0;
+}
+
 /* Return nonzero iff clause 'c' has qrat on literal 'lit'. */
 static int
 has_qrat_on_literal (QRATPrePlus * qr, Clause *c, LitID lit)
@@ -149,42 +775,48 @@ has_qrat_on_literal (QRATPrePlus * qr, Clause *c, LitID lit)
   ClausePtrStack *comp_occs = LIT_NEG (lit) ? 
     &(var->pos_occ_clauses) : &(var->neg_occ_clauses);
 
+  if (is_pivot_over_occ_limit (qr, var, comp_occs))
+    return 0;
+
+  /* Resolvent limit requires sequential checking in order. Stale entries
+     are not skipped by parallel checks. */
+  if (qr->workers && qr->limit_max_resolvents == UINT_MAX &&
+      COUNT_STACK (*comp_occs) > qr->options.split_occs_threshold &&
+      count_occs (var, comp_occs) == COUNT_STACK (*comp_occs))
+    return has_qrat_on_literal_parallel (qr, c, lit, comp_occs);
+
   /* Check all possible resolution candidates on literal 'lit' and
      clauses on 'comp_occs'. Must ignore already redundant
      occurrences. */
+  unsigned int pos = 0;
   Clause **occ_p, **occ_e;
   for (occ_p = comp_occs->start, occ_e = comp_occs->top; occ_p < occ_e; occ_p++)
     {
       /* Do QRAT test either with or without EABS (controlled by option '--eabs'). */
       Clause *occ = *occ_p;
       
-      if (occ->redundant)
+      if (occ->redundant || is_stale_occ (qr, occ, -lit))
         continue;
 
+      if (is_resolvent_limit_reached (qr))
+        return 0;
+
+      if (qr->is_worker)
+        record_used_clause (qr, occ);
+
       qr->clause_redundancy_or_checks++;
       qr->clause_redundancy_or_checks_lits_seen += occ->num_lits;
       
       if (!qrat_qbcp_check (qr, c, lit, occ))
         {
+          /* Collect 'occ' as a witness for non-redundancy of 'c' (on
+             'lit'). */
           if (var->qblock->type == QTYPE_EXISTS)
-            {
-              /* Collect 'occ' as a witness for non-redundancy of 'c' (on
-                 'lit'). */
-              if (!occ->witness)
-                {
-                  if (qr->options.verbosity >= 2)
-                    {
-                      fprintf (stderr, "  clause ");
-                      print_lits (qr, stderr, occ->lits, occ->num_lits, 1);
-                      fprintf (stderr, "    is witness of: ");
-                      print_lits (qr, stderr, c->lits, c->num_lits, 1);
-                    }
-                  occ->witness = 1;
-                  PUSH_STACK (qr->mm, qr->witness_clauses, occ);
-                }
-            }
+            collect_witness_clause (qr, c, occ);
+          record_witness_position (qr, comp_occs, occ_p, pos);
           return 0;
         }
+      pos++;
     }
   /* All candidates fulfill tautology property of QBCE, hence 'lit' 
      is blocking literal in clause 'c'. */
@@ -203,34 +835,32 @@ is_literal_blocking (QRATPrePlus * qr, Clause *c, LitID lit)
   /* Set pointer to stack of clauses containing literals complementary to 'lit'. */
   ClausePtrStack *comp_occs = LIT_NEG (lit) ? 
     &(var->pos_occ_clauses) : &(var->neg_occ_clauses);
+  if (is_pivot_over_occ_limit (qr, var, comp_occs))
+    return 0;
+  ClauseSig c_outer_sig = get_outer_signature (qr, c, lit);
 
   /* Check all possible resolution candidates on literal 'lit' and
      clauses on 'comp_occs'. Must ignore already redundant
      occurrences. */
+  unsigned int pos = 0;
   Clause **occ_p, **occ_e;
   for (occ_p = comp_occs->start, occ_e = comp_occs->top; occ_p < occ_e; occ_p++)
     {
       Clause *occ = *occ_p; 
-      if (!occ->redundant &&
-          /* Syntactic check for tautology, i.e., QBCE check. */
-          !check_outer_tautology (qr, c, lit, occ))
+      if (occ->redundant || is_stale_occ (qr, occ, -lit))
+        continue;
+      if (is_resolvent_limit_reached (qr))
+        return 0;
+      /* Syntactic check for tautology, i.e., QBCE check. */
+      if (!qr->outer_tautology_kernel (qr, c, lit, occ, c_outer_sig))
         {
+          record_witness_position (qr, comp_occs, occ_p, pos);
           /* Collect 'occ' as a witness for non-redundancy of 'c' (on
              'lit'). */
-          if (!occ->witness)
-            {
-              if (qr->options.verbosity >= 2)
-                {
-                  fprintf (stderr, "  clause ");
-                  print_lits (qr, stderr, occ->lits, occ->num_lits, 1);
-                  fprintf (stderr, "    is witness of: ");
-                  print_lits (qr, stderr, c->lits, c->num_lits, 1);
-                }
-              occ->witness = 1;
-              PUSH_STACK (qr->mm, qr->witness_clauses, occ);
-            }
+          collect_witness_clause (qr, c, occ);
           return 0;
         }
+      pos++;
     }
   /* All candidates fulfill tautology property of QBCE, hence 'lit' 
      is blocking literal in clause 'c'. */
@@ -242,6 +872,7 @@ static int
 has_clause_qrat (QRATPrePlus * qr, Clause *c)
 {
   assert (!c->redundant);
+  qr->cur_resolvents = 0;
   LitID *p, *e;
   for (p = c->lits, e = p + c->num_lits; p < e; p++)
     {
@@ -270,19 +901,27 @@ is_literal_blocked (QRATPrePlus * qr, Clause *c, LitID lit)
   /* Set pointer to stack of clauses containing literals complementary to 'lit'. */
   ClausePtrStack *comp_occs = LIT_NEG (lit) ? 
     &(var->pos_occ_clauses) : &(var->neg_occ_clauses);
+  if (is_pivot_over_occ_limit (qr, var, comp_occs))
+    return 0;
+  ClauseSig c_outer_sig = get_outer_signature (qr, c, lit);
 
   /* Check all possible resolution candidates on literal 'lit' and
      clauses on 'comp_occs'. Must ignore already redundant
      occurrences. */
+  unsigned int pos = 0;
   Clause **occ_p, **occ_e;
   for (occ_p = comp_occs->start, occ_e = comp_occs->top; occ_p < occ_e; occ_p++)
     {
       Clause *occ = *occ_p; 
-      if (!occ->redundant &&
-          /* Syntactic check for tautology, i.e., QBCE check. */
-          !check_outer_tautology (qr, c, lit, occ))
+      if (occ->redundant || is_stale_occ (qr, occ, -lit))
+        continue;
+      if (is_resolvent_limit_reached (qr))
+        return 0;
+      /* Syntactic check for tautology, i.e., QBCE check. */
+      if (!qr->outer_tautology_kernel (qr, c, lit, occ, c_outer_sig))
         {
-          if (qr->options.verbosity >= 2)
+          record_witness_position (qr, comp_occs, occ_p, pos);
+          if (QRATPREPLUS_TRACE (qr))
             {
               fprintf (stderr, "  clause ");
               print_lits (qr, stderr, occ->lits, occ->num_lits, 1);
@@ -291,6 +930,7 @@ is_literal_blocked (QRATPrePlus * qr, Clause *c, LitID lit)
             }
           return 0;
         }
+      pos++;
     }
   /* All candidates fulfill tautology property of QBCE, hence 'lit' 
      is blocked in clause 'c'. */
@@ -302,6 +942,7 @@ static int
 is_clause_blocked (QRATPrePlus * qr, Clause *c)
 {
   assert (!c->redundant);
+  qr->cur_resolvents = 0;
   LitID *p, *e;
   for (p = c->lits, e = p + c->num_lits; p < e; p++)
     {
@@ -318,6 +959,103 @@ is_clause_blocked (QRATPrePlus * qr, Clause *c)
   return 0;
 }
 
+/* Returns nonzero iff the complementary occurrences of some literal in
+   clause 'c' exceed the limit 'limit_max_occ_cnt'. */
+static int
+clause_exceeds_occ_limit (QRATPrePlus * qr, Clause *c)
+{
+  if (qr->limit_max_occ_cnt == UINT_MAX || qr->options.per_pivot_occ_limit)
+    return 0;
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    {
+      LitID lit =  *p;
+      Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+      ClausePtrStack *compl_occs = LIT_NEG (lit) ? 
+        &var->pos_occ_clauses : &var->neg_occ_clauses;
+      if (qr->limit_max_occ_cnt < count_occs (var, compl_occs))
+        return 1;
+    }
+  return 0;
+}
+
+static int
+compare_occs_short_first (const void * cp1, const void * cp2)
+{
+  Clause *c1 = *(Clause **) cp1;
+  Clause *c2 = *(Clause **) cp2;
+  if (c1->num_lits != c2->num_lits)
+    return c1->num_lits < c2->num_lits ? -1 : 1;
+  return c1->id < c2->id ? -1 : (c1->id > c2->id);
+}
+
+/* Clauses with a literal from a more deeply nested qblock first, which
+   are less likely to produce outer tautologies. Ties are broken by
+   preferring short clauses. */
+static int
+compare_occs_inner_first (const void * cp1, const void * cp2)
+{
+  Clause *c1 = *(Clause **) cp1;
+  Clause *c2 = *(Clause **) cp2;
+  Nesting n1 = c1->num_lits ? CLAUSE_NESTINGS (c1)[c1->num_lits - 1] : 0;
+  Nesting n2 = c2->num_lits ? CLAUSE_NESTINGS (c2)[c2->num_lits - 1] : 0;
+  if (n1 != n2)
+    return n1 > n2 ? -1 : 1;
+  return compare_occs_short_first (cp1, cp2);
+}
+
+void
+order_occurrences (QRATPrePlus * qr)
+{
+  int (*compare) (const void *, const void *);
+  if (qr->options.occ_order == OCC_ORDER_SHORT)
+    compare = compare_occs_short_first;
+  else if (qr->options.occ_order == OCC_ORDER_INNER)
+    compare = compare_occs_inner_first;
+  else
+    return;
+
+  Var *var, *vars_end;
+  for (var = qr->pcnf.vars, vars_end = var + qr->pcnf.size_vars; 
+       var < vars_end; var++)
+    {
+      if (COUNT_STACK (var->neg_occ_clauses) > 1)
+        qsort (var->neg_occ_clauses.start, COUNT_STACK (var->neg_occ_clauses),
+               sizeof (Clause *), compare);
+      if (COUNT_STACK (var->pos_occ_clauses) > 1)
+        qsort (var->pos_occ_clauses.start, COUNT_STACK (var->pos_occ_clauses),
+               sizeof (Clause *), compare);
+    }
+}
+
+void
+mark_clauses_exceeding_occ_limit (QRATPrePlus * qr)
+{
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    c->exceeds_occ_limit = clause_exceeds_occ_limit (qr, c);
+}
+
+/* Update marks of clauses after clauses were removed from occurrences
+   'occs' of variable 'var', which had 'old_cnt' entries before. Only if
+   'occs' drops below the limit, then the clauses with the complementary
+   literal may now be within the limit. Occurrences never grow during
+   preprocessing. */
+static void
+update_occ_limit_marks (QRATPrePlus * qr, Var *var, ClausePtrStack *occs,
+                        unsigned int old_cnt)
+{
+  if (old_cnt <= qr->limit_max_occ_cnt ||
+      count_occs (var, occs) > qr->limit_max_occ_cnt)
+    return;
+  ClausePtrStack *compl_occs = occs == &var->neg_occ_clauses ?
+    &var->pos_occ_clauses : &var->neg_occ_clauses;
+  Clause **cp, **ce;
+  for (cp = compl_occs->start, ce = compl_occs->top; cp < ce; cp++)
+    if ((*cp)->exceeds_occ_limit)
+      (*cp)->exceeds_occ_limit = clause_exceeds_occ_limit (qr, *cp);
+}
+
 /* Returns nonzero iff clause 'c' meets the current limits (if not, then 'c'
    is not checked for redundancy). */
 static int
@@ -325,7 +1063,7 @@ reschedule_is_clause_within_limits (QRATPrePlus * qr, Clause *c)
 {
   if (c->num_lits < qr->limit_min_clause_len)
     {
-      if (qr->options.verbosity >= 2)
+      if (QRATPREPLUS_TRACE (qr))
         {
           fprintf (stderr, "Clause ID %u not rescheduled, length %u less than min-length %u: ", 
                    c->id, c->num_lits, qr->limit_min_clause_len);
@@ -335,7 +1073,7 @@ reschedule_is_clause_within_limits (QRATPrePlus * qr, Clause *c)
     }
   if (qr->limit_max_clause_len < c->num_lits)
     {
-      if (qr->options.verbosity >= 2)
+      if (QRATPREPLUS_TRACE (qr))
         {
           fprintf (stderr, "Clause ID %u not rescheduled, length %u greater than max-length %u: ", 
                    c->id, c->num_lits, qr->limit_max_clause_len);
@@ -344,23 +1082,16 @@ reschedule_is_clause_within_limits (QRATPrePlus * qr, Clause *c)
       return 0;
     }
 
-  LitID *p, *e;
-  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+  assert (c->exceeds_occ_limit == clause_exceeds_occ_limit (qr, c));
+  if (c->exceeds_occ_limit)
     {
-      LitID lit =  *p;
-      Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
-      ClausePtrStack *compl_occs = LIT_NEG (lit) ? 
-        &var->pos_occ_clauses : &var->neg_occ_clauses;
-      if (qr->limit_max_occ_cnt < (unsigned int) COUNT_STACK (*compl_occs))
+      if (QRATPREPLUS_TRACE (qr))
         {
-          if (qr->options.verbosity >= 2)
-            {
-              fprintf (stderr, "Clause ID %u not rescheduled, compl-occs count %u greater than max occ count %u: ", 
-                       c->id, (unsigned int) COUNT_STACK (*compl_occs), qr->limit_max_occ_cnt);
-              print_lits (qr, stderr, c->lits, c->num_lits, 1);
-            }
-          return 0;
+          fprintf (stderr, "Clause ID %u not rescheduled, compl-occs count greater than max occ count %u: ", 
+                   c->id, qr->limit_max_occ_cnt);
+          print_lits (qr, stderr, c->lits, c->num_lits, 1);
         }
+      return 0;
     }
 
   if (qr->options.ignore_outermost_vars &&
@@ -380,7 +1111,7 @@ static void
 reschedule_from_redundant_clause (QRATPrePlus * qr, Clause *c, 
                                   ClausePtrStack *rescheduled)
 {
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     {
       fprintf (stderr, "    Rescheduling from redundant clause: ");
       print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -397,12 +1128,12 @@ reschedule_from_redundant_clause (QRATPrePlus * qr, Clause *c,
       for (cp = compl_occs->start, ce = compl_occs->top; cp < ce; cp++)
         {
           oc = *cp;
-          if (!oc->redundant)
+          if (!oc->redundant && !is_stale_occ (qr, oc, -lit))
             if (!oc->rescheduled && reschedule_is_clause_within_limits (qr, oc))
               {
                 oc->rescheduled = 1;
                 PUSH_STACK (qr->mm, *rescheduled, oc);
-                if (qr->options.verbosity >= 2)
+                if (QRATPREPLUS_TRACE (qr))
                   {
                     fprintf (stderr, "    rescheduled clause: ");
                     print_lits (qr, stderr, oc->lits, oc->num_lits, 1);
@@ -430,7 +1161,7 @@ static void
 reschedule_from_redundant_witness_clauses (QRATPrePlus *qr, 
                                            ClausePtrStack *rescheduled)
 {
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     fprintf (stderr, "\nRescheduling from %u witness clauses\n", 
              (unsigned int) COUNT_STACK (qr->witness_clauses));
 
@@ -443,7 +1174,7 @@ reschedule_from_redundant_witness_clauses (QRATPrePlus *qr,
       assert (c->witness);
       if (c->redundant)
         {
-          if (qr->options.verbosity >= 2)
+          if (QRATPREPLUS_TRACE (qr))
             {
               fprintf (stderr, "  Redundant witness clause: ");
               print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -457,7 +1188,7 @@ reschedule_from_redundant_witness_clauses (QRATPrePlus *qr,
         }
       else
         {
-          if (qr->options.verbosity >= 2)
+          if (QRATPREPLUS_TRACE (qr))
             {
               fprintf (stderr, "  Non-redundant witness clause: ");
               print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -466,16 +1197,105 @@ reschedule_from_redundant_witness_clauses (QRATPrePlus *qr,
     }
 }
 
+/* Number of bits of a clause ID sorted per pass of the radix sort. */
+#define QRATPLUS_RADIX_BITS 8
+#define QRATPLUS_RADIX_SIZE (1 << QRATPLUS_RADIX_BITS)
+
+/* Sort clauses on 'to_be_checked' by ID using a stable LSD radix sort,
+   i.e., in linear time. Passes on digits that are zero in all IDs are
+   skipped, hence small IDs need only one or two passes. */
+static void
+sort_clauses_by_id (QRATPrePlus * qr, ClausePtrStack *to_be_checked)
+{
+  const size_t cnt = COUNT_STACK (*to_be_checked);
+  if (cnt <= 1)
+    return;
+
+  ClauseID max_id = 0;
+  Clause **cp, **ce;
+  for (cp = to_be_checked->start, ce = to_be_checked->top; cp < ce; cp++)
+    if ((*cp)->id > max_id)
+      max_id = (*cp)->id;
+
+  Clause **buffer = mm_malloc (qr->mm, cnt * sizeof (Clause *));
+  Clause **from = to_be_checked->start, **to = buffer;
+  unsigned int shift;
+  for (shift = 0; shift < sizeof (ClauseID) * 8 && (max_id >> shift);
+       shift += QRATPLUS_RADIX_BITS)
+    {
+      size_t offsets[QRATPLUS_RADIX_SIZE];
+      memset (offsets, 0, sizeof (offsets));
+      size_t i;
+      for (i = 0; i < cnt; i++)
+        offsets[(from[i]->id >> shift) & (QRATPLUS_RADIX_SIZE - 1)]++;
+      size_t sum = 0, d;
+      for (d = 0; d < QRATPLUS_RADIX_SIZE; d++)
+        {
+          size_t tmp = offsets[d];
+          offsets[d] = sum;
+          sum += tmp;
+        }
+      for (i = 0; i < cnt; i++)
+        to[offsets[(from[i]->id >> shift) & (QRATPLUS_RADIX_SIZE - 1)]++] =
+          from[i];
+      Clause **tmp = from;
+      from = to;
+      to = tmp;
+    }
+
+  /* Sorted clauses are in 'buffer' after an odd number of passes. */
+  if (from != to_be_checked->start)
+    memcpy (to_be_checked->start, from, cnt * sizeof (Clause *));
+  mm_free (qr->mm, buffer, cnt * sizeof (Clause *));
+
+#ifndef NDEBUG
+  for (cp = to_be_checked->start + 1, ce = to_be_checked->top; cp < ce; cp++)
+    assert ((*(cp - 1))->id <= (*cp)->id);
+#endif
+}
+
+/* Lexicographic ordering of clauses by literals, which are sorted by
+   nesting levels, i.e., clauses sharing a prefix of outer literals are
+   adjacent. Ties are broken by IDs. */
 static int
-compare_clauses_by_id (const void * cp1, const void * cp2)
+compare_clauses_by_outer_lits (const void * cp1, const void * cp2)
 {
-  Clause *c1 = (Clause *) cp1;
-  Clause *c2 = (Clause *) cp2;
-  if (c1->id < c2->id)
-    return -1;
-  else if (c1->id > c2->id)
-    return 1;
-  else return 0;
+  Clause *c1 = *(Clause **) cp1;
+  Clause *c2 = *(Clause **) cp2;
+  Nesting *n1 = CLAUSE_NESTINGS (c1), *n2 = CLAUSE_NESTINGS (c2);
+  unsigned int i, num = c1->num_lits < c2->num_lits ?
+    c1->num_lits : c2->num_lits;
+  for (i = 0; i < num; i++)
+    {
+      if (n1[i] != n2[i])
+        return n1[i] < n2[i] ? -1 : 1;
+      if (c1->lits[i] != c2->lits[i])
+        return c1->lits[i] < c2->lits[i] ? -1 : 1;
+    }
+  if (c1->num_lits != c2->num_lits)
+    return c1->num_lits < c2->num_lits ? -1 : 1;
+  return c1->id < c2->id ? -1 : (c1->id > c2->id);
+}
+
+/* Sort clauses on 'to_be_checked' such that consecutive checks see the
+   same outer assignments and occurrence lists. */
+static void
+sort_clauses_by_outer_lits (ClausePtrStack *to_be_checked)
+{
+  if (COUNT_STACK (*to_be_checked) < 2)
+    return;
+  qsort (to_be_checked->start, COUNT_STACK (*to_be_checked),
+         sizeof (Clause *), compare_clauses_by_outer_lits);
+}
+
+/* Sort clauses to be checked by ID or, if enabled, by outer literals. */
+static void
+sort_clauses_to_be_checked (QRATPrePlus * qr, ClausePtrStack *to_be_checked)
+{
+  if (qr->options.group_checks)
+    sort_clauses_by_outer_lits (to_be_checked);
+  else
+    sort_clauses_by_id (qr, to_be_checked);
 }
 
 static void
@@ -483,7 +1303,7 @@ permute_clauses_to_be_checked (QRATPrePlus * qr, ClausePtrStack *to_be_checked)
 {
   if (!EMPTY_STACK (*to_be_checked))
     {
-      if (qr->options.verbosity >= 2)
+      if (QRATPREPLUS_TRACE (qr))
         {
           fprintf (stderr, "Sequence before permuting: ");
           Clause **cp, **ce;
@@ -509,7 +1329,7 @@ permute_clauses_to_be_checked (QRATPrePlus * qr, ClausePtrStack *to_be_checked)
           to_be_checked->start[j] = tmp;
         }
 
-      if (qr->options.verbosity >= 2)
+      if (QRATPREPLUS_TRACE (qr))
         {
           fprintf (stderr, "Sequence after permuting: ");
           Clause **cp, **ce;
@@ -553,6 +1373,351 @@ reschedule_from_input_clauses (QRATPrePlus * qr, ClausePtrStack *rescheduled)
     }
 }
 
+/* Thread function of a worker: check clauses claimed from the shared work
+   list for QBCE with respect to the formula as it was at the beginning of
+   the current iteration. */
+static void *
+run_qbce_worker (void *arg)
+{
+  Worker *w = (Worker *) arg;
+  QRATPrePlus *qr = &w->qr;
+  WorkList *work = w->work;
+  unsigned int i, e;
+  while (claim_chunk (work, &i, &e))
+    for (; i < e; i++)
+      {
+        Clause *c = work->clauses[i];
+        if (c->redundant)
+          continue;
+        if (worker_exceeded_soft_time_limit (qr, work, &qr->cnt_qbce_checks))
+          break;
+        if (is_clause_blocked (qr, c))
+          PUSH_STACK (qr->mm, w->redundant, c);
+      }
+  return 0;
+}
+
+/* Thread function of a worker: check clauses claimed from the shared work
+   list for QRAT or AT on the private copy of the formula, which reflects the
+   formula as it was at the beginning of the current window. Record
+   witnesses and clauses used in each check for committing the result. */
+static void *
+run_speculative_worker (void *arg)
+{
+  Worker *w = (Worker *) arg;
+  QRATPrePlus *qr = &w->qr;
+  WorkList *work = w->work;
+  unsigned int i, e;
+  while (claim_chunk (work, &i, &e))
+    for (; i < e; i++)
+      {
+        Clause *c = w->clones[work->clauses[i]->id];
+        CheckResult *r = work->results + i;
+        r->worker = w;
+        r->witnesses_start = r->witnesses_end = COUNT_STACK (w->witness_ids);
+        r->used_start = r->used_end = COUNT_STACK (w->used_ids);
+        if (!c || c->redundant)
+          {
+            r->checked = 1;
+            continue;
+          }
+        if (worker_exceeded_soft_time_limit (qr, work, &qr->cnt_qbce_checks))
+          break;
+        if (work->mode == QRATPLUS_CHECK_MODE_QRAT &&
+            has_clause_high_occ_pivot (qr, c))
+          {
+            r->deferred = 1;
+            r->checked = 1;
+            continue;
+          }
+
+        r->redundant = work->mode == QRATPLUS_CHECK_MODE_QRAT ?
+          has_clause_qrat (qr, c) : qrat_qat_check (qr, c);
+
+        Clause **cp, **ce;
+        for (cp = qr->witness_clauses.start, ce = qr->witness_clauses.top;
+             cp < ce; cp++)
+          PUSH_STACK (qr->mm, w->witness_ids, (*cp)->id);
+        RESET_STACK (qr->witness_clauses);
+        for (cp = qr->used_clauses.start, ce = qr->used_clauses.top;
+             cp < ce; cp++)
+          PUSH_STACK (qr->mm, w->used_ids, (*cp)->id);
+        reset_used_clauses (qr);
+        r->witnesses_end = COUNT_STACK (w->witness_ids);
+        r->used_end = COUNT_STACK (w->used_ids);
+        r->checked = 1;
+      }
+  return 0;
+}
+
+static void
+mark_clause_redundant (QRATPrePlus * qr, Clause *c)
+{
+  assert (!c->redundant);
+  if (QRATPREPLUS_TRACE (qr))
+    {
+      fprintf (stderr, "  ==> Clause ");
+      print_lits (qr, stderr, c->lits, c->num_lits, 1);
+      fprintf (stderr, " is redundant.\n");
+    }
+  c->redundant = 1;
+  PUSH_STACK (qr->mm, qr->redundant_clauses, c);
+}
+
+static void
+mark_clause_subsumed (QRATPrePlus * qr, Clause *c)
+{
+  mark_clause_redundant (qr, c);
+  qr->cnt_redundant_clauses++;
+  qr->cnt_subsumed_clauses++;
+}
+
+/* Returns the literal of 'c' with fewest occurrences. */
+static LitID
+get_min_occ_literal (QRATPrePlus * qr, Clause *c)
+{
+  assert (c->num_lits > 0);
+  LitID result = 0;
+  unsigned int min = UINT_MAX;
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    {
+      Var *var = LIT2VARPTR (qr->pcnf.vars, *p);
+      ClausePtrStack *occs = LIT_NEG (*p) ?
+        &var->neg_occ_clauses : &var->pos_occ_clauses;
+      unsigned int cnt = count_occs (var, occs);
+      if (cnt < min)
+        {
+          min = cnt;
+          result = *p;
+        }
+    }
+  return result;
+}
+
+/* Mark the clauses subsumed by 'c' as redundant. Every such clause
+   contains the literal of 'c' with fewest occurrences. */
+static void
+mark_clauses_subsumed_by (QRATPrePlus * qr, Clause *c)
+{
+  LitID lit = get_min_occ_literal (qr, c);
+  Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+  ClausePtrStack *occs = LIT_NEG (lit) ?
+    &var->neg_occ_clauses : &var->pos_occ_clauses;
+  Clause **cp, **ce;
+  for (cp = occs->start, ce = occs->top; cp < ce; cp++)
+    {
+      Clause *d = *cp;
+      if (d == c || d->redundant || is_stale_occ (qr, d, lit))
+        continue;
+      if (qr->options.ignore_outermost_vars &&
+          clause_has_outermost_qblock_literal (qr, d))
+        continue;
+      if (c->sig & ~d->sig)
+        {
+          qr->clause_redundancy_or_checks_sig_filtered++;
+          continue;
+        }
+      if (is_clause_subset (c, d))
+        mark_clause_subsumed (qr, d);
+    }
+}
+
+/* Merge clauses found redundant and witnesses of QBCE worker 'w' into
+   'qr'. Returns the number of new redundant clauses. */
+static unsigned int
+merge_worker_results (QRATPrePlus * qr, Worker *w)
+{
+  unsigned int result = COUNT_STACK (w->redundant);
+  Clause **cp, **ce;
+  for (cp = w->redundant.start, ce = w->redundant.top; cp < ce; cp++)
+    mark_clause_redundant (qr, *cp);
+  RESET_STACK (w->redundant);
+
+  /* Witnesses may have been collected by several workers. */
+  for (cp = w->qr.witness_clauses.start, ce = w->qr.witness_clauses.top;
+       cp < ce; cp++)
+    {
+      Clause *c = *cp;
+      if (!c->witness)
+        {
+          c->witness = 1;
+          PUSH_STACK (qr->mm, qr->witness_clauses, c);
+        }
+    }
+  RESET_STACK (w->qr.witness_clauses);
+
+  return result;
+}
+
+/* Check all clauses on 'to_be_checked' for QBCE using 'qr->options.threads'
+   workers. All clauses are checked with respect to the formula as it was at
+   the beginning of the iteration and clauses found redundant are marked
+   only after all workers have finished. Since QBCE is confluent, this
+   results in the same fixpoint as sequential checking. Sets 'exceeded' if
+   the soft time limit was exceeded. Returns the number of new redundant
+   clauses. */
+static unsigned int
+find_and_mark_blocked_clauses_parallel (QRATPrePlus * qr, Worker *workers,
+                                        ClausePtrStack *to_be_checked,
+                                        int *exceeded)
+{
+  unsigned int i, num_workers = qr->options.threads;
+  WorkList *work = workers[0].work;
+  work->clauses = to_be_checked->start;
+  work->cnt = COUNT_STACK (*to_be_checked);
+  work->next = 0;
+  work->chunk_size = QRATPLUS_WORKER_CHUNK_SIZE;
+  work->exceeded = 0;
+
+  run_workers (qr, workers, run_qbce_worker);
+
+  unsigned int result = 0;
+  for (i = 0; i < num_workers; i++)
+    {
+      result += merge_worker_results (qr, workers + i);
+      merge_worker_stats (qr, workers + i);
+    }
+
+  if ((*exceeded = work->exceeded))
+    fprintf (stderr, "Exceeded soft time limit of %u sec after %llu clause checks\n",
+             qr->soft_time_limit, qr->cnt_qbce_checks);
+  return result;
+}
+
+/* Commit result 'r' of the speculative check of clause 'c'. The check was
+   done on the formula as it was at the beginning of the window and is
+   valid for the current formula if none of the clauses used in the check
+   has been found redundant since then: propagation in QBCP is monotone in
+   the set of clauses, and the same occurrences are visited in the same
+   order. Then the result and the witnesses are exactly the same as in a
+   sequential check. Otherwise, the check is repeated. Returns nonzero iff
+   'c' is redundant. */
+static int
+commit_speculative_result (QRATPrePlus * qr, WorkList *work, Clause *c,
+                           CheckResult *r)
+{
+  if (r->deferred)
+    return has_clause_qrat (qr, c);
+
+  Worker *w = r->worker;
+  ClauseID *p, *e;
+  for (p = w->used_ids.start + r->used_start,
+         e = w->used_ids.start + r->used_end; p < e; p++)
+    if (work->clauses_by_id[*p]->redundant)
+      break;
+
+  if (p < e)
+    {
+      qr->cnt_speculative_rechecks++;
+      return work->mode == QRATPLUS_CHECK_MODE_QRAT ?
+        has_clause_qrat (qr, c) : qrat_qat_check (qr, c);
+    }
+
+  for (p = w->witness_ids.start + r->witnesses_start,
+         e = w->witness_ids.start + r->witnesses_end; p < e; p++)
+    collect_witness_clause (qr, c, work->clauses_by_id[*p]);
+  return r->redundant;
+}
+
+/* Check all clauses on 'to_be_checked' for QRAT or AT using
+   'qr->options.threads' workers. QRAT is not confluent, hence the result
+   must not depend on the order in which clauses are checked. Workers check
+   the clauses of a window speculatively on private copies of the formula,
+   then the results are committed in the order of 'to_be_checked' as in
+   sequential checking (see 'commit_speculative_result'). Sets 'exceeded'
+   if the soft time limit was exceeded. Returns the number of new redundant
+   clauses. */
+static unsigned int
+find_and_mark_redundant_clauses_speculative (QRATPrePlus * qr,
+                                             Worker *workers,
+                                             ClausePtrStack *to_be_checked,
+                                             int *exceeded)
+{
+  unsigned int i, num_workers = qr->options.threads;
+  WorkList *work = workers[0].work;
+  unsigned int result = 0;
+  unsigned int window_start, cnt = COUNT_STACK (*to_be_checked);
+
+  for (window_start = 0; !*exceeded && window_start < cnt;
+       window_start += QRATPLUS_SPECULATION_WINDOW)
+    {
+      work->clauses = to_be_checked->start + window_start;
+      work->cnt = cnt - window_start < QRATPLUS_SPECULATION_WINDOW ?
+        cnt - window_start : QRATPLUS_SPECULATION_WINDOW;
+      work->next = 0;
+      work->chunk_size = QRATPLUS_SPECULATIVE_CHUNK_SIZE;
+      work->exceeded = 0;
+      memset (work->results, 0, work->cnt * sizeof (CheckResult));
+      for (i = 0; i < num_workers; i++)
+        {
+          sync_formula_clone (qr, workers + i);
+          RESET_STACK (workers[i].witness_ids);
+          RESET_STACK (workers[i].used_ids);
+        }
+
+      run_workers (qr, workers, run_speculative_worker);
+
+      /* Commit results in order, stop at first clause not checked due to
+         time limit. */
+      for (i = 0; i < work->cnt; i++)
+        {
+          Clause *c = work->clauses[i];
+          CheckResult *r = work->results + i;
+          if (!r->checked)
+            {
+              *exceeded = 1;
+              break;
+            }
+          if (!c->redundant && commit_speculative_result (qr, work, c, r))
+            {
+              mark_clause_redundant (qr, c);
+              result++;
+            }
+        }
+
+      for (i = 0; i < num_workers; i++)
+        merge_worker_stats (qr, workers + i);
+    }
+
+  if (*exceeded)
+    fprintf (stderr, "Exceeded soft time limit of %u sec after %llu clause checks\n",
+             qr->soft_time_limit, qr->cnt_qbce_checks);
+  return result;
+}
+
+/* Returns nonzero iff the iterations of a phase should be stopped because
+   the last iteration was much less productive than the first one. Then
+   the clauses rescheduled for the next iteration are dropped. The next
+   iteration is estimated to take as long as the last one scaled by the
+   number of rescheduled clauses. */
+static int
+stop_phase_on_diminishing_returns (QRATPrePlus * qr, const char *phase,
+                                   double *first_rate,
+                                   unsigned int eliminations,
+                                   double iteration_start,
+                                   unsigned int cnt_checked,
+                                   ClausePtrStack *rescheduled)
+{
+  if (!qr->min_elim_rate)
+    return 0;
+  double time = wall_time_stamp () - iteration_start;
+  double next_time = cnt_checked ?
+    time * COUNT_STACK (*rescheduled) / cnt_checked : time;
+  if (!is_elimination_rate_diminished (qr, phase, first_rate, eliminations,
+                                       time, next_time))
+    return 0;
+
+  Clause **cp, **ce;
+  for (cp = rescheduled->start, ce = rescheduled->top; cp < ce; cp++)
+    {
+      assert ((*cp)->rescheduled);
+      (*cp)->rescheduled = 0;
+    }
+  RESET_STACK (*rescheduled);
+  return 1;
+}
+
 /* Returns nonzero iff redundant clauses were found. */
 static int
 find_and_mark_redundant_clauses_aux (QRATPrePlus * qr, 
@@ -589,6 +1754,37 @@ find_and_mark_redundant_clauses_aux (QRATPrePlus * qr,
   }
 #endif
 
+  /* Check clauses in parallel in QBCE mode and speculatively in QRATE and AT
+     mode if multiple threads are enabled. If a QBCP propagation limit is set,
+     then speculative checks may give results different from sequential
+     checks. */
+  WorkList work;
+  memset (&work, 0, sizeof (work));
+  Worker *workers = 0;
+  const int speculative = mode != QRATPLUS_CHECK_MODE_QBCE &&
+    qr->options.threads > 1 && 
+    (!qr->options.deterministic || qr->limit_qbcp_cur_props == UINT_MAX);
+  if (speculative)
+    {
+      work.mode = mode;
+      work.results = mm_malloc (qr->mm, QRATPLUS_SPECULATION_WINDOW *
+                                sizeof (CheckResult));
+      work.clauses_by_id = mm_malloc (qr->mm, (qr->cur_clause_id + 1) *
+                                      sizeof (Clause *));
+      Clause *c;
+      for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+        work.clauses_by_id[c->id] = c;
+      workers = create_workers (qr, &work, 1);
+      if (mode == QRATPLUS_CHECK_MODE_QRAT)
+        qr->workers = workers;
+    }
+  else if (mode == QRATPLUS_CHECK_MODE_QBCE && qr->options.threads > 1)
+    workers = create_workers (qr, &work, 0);
+
+  const char *phase_name = mode == QRATPLUS_CHECK_MODE_QBCE ? "QBCE" :
+    (mode == QRATPLUS_CHECK_MODE_AT ? "AT" : "QRATE");
+  double first_rate = -1;
+  int cutoff = 0;
   unsigned int cur_redundant_clauses = 0;
   int changed = 1;
   while (!exceeded && changed)
@@ -596,6 +1792,7 @@ find_and_mark_redundant_clauses_aux (QRATPrePlus * qr,
       /* Statistics. */
       qr->cnt_redundant_clauses += cur_redundant_clauses;
       qr->cnt_qbce_iterations++;
+      double iteration_start = wall_time_stamp ();
 
       /* Set up new iteration: swap 'rescheduled' and 'to_be_checked', reset. */
       changed = 0;
@@ -617,73 +1814,88 @@ find_and_mark_redundant_clauses_aux (QRATPrePlus * qr,
       if (qr->options.verbosity >= 1)
         {
           fprintf (stderr, "\n======\n%s iteration %d: %d new redundant clauses in previous iteration %d\n", 
-                   mode == QRATPLUS_CHECK_MODE_QBCE ? "QBCE" : (mode == QRATPLUS_CHECK_MODE_AT ? "AT" : "QRATE"),
+                   phase_name,
                    qr->cnt_qbce_iterations, cur_redundant_clauses, qr->cnt_qbce_iterations - 1);
           fprintf (stderr, "Clauses to be checked (worst case): %u ( %f %% of original CNF)\n======\n", 
                    (unsigned int) COUNT_STACK (*to_be_checked), 100 * (COUNT_STACK (*to_be_checked) / (float) qr->actual_num_clauses));
         }
       cur_redundant_clauses = 0;
 
-      /* Either randomly permute or sort clauses to be tested by ID. Note that
+      /* Either randomly permute or sort clauses to be tested by ID (or by
+         outer literals with '--group-checks'). Note that
          without sorting we may get different orderings due to the way we
          reschedule clauses. */
       if (mode != QRATPLUS_CHECK_MODE_QBCE && qr->options.permute)
         permute_clauses_to_be_checked (qr, to_be_checked);
       else
-        qsort (to_be_checked->start, COUNT_STACK (*to_be_checked), 
-               sizeof (Clause *), compare_clauses_by_id);
+        sort_clauses_to_be_checked (qr, to_be_checked);
 
-      for (cp = to_be_checked->start, ce = to_be_checked->top;
-           !exceeded && cp < ce; cp++)
+      if (workers)
         {
-          Clause *c = *cp;
-          assert (!qr->options.ignore_outermost_vars ||
-                  !clause_has_outermost_qblock_literal (qr, c));
-          
-          /* NOTE: we may encounter clauses 'c' with 'c->redundant' true
-             because such clauses may appear on 'rescheduled' (see comment above)
-             and we just swap the sets at the beginning of each iteration. */
-          if (!c->redundant)
+          unsigned int cnt = speculative ?
+            find_and_mark_redundant_clauses_speculative
+            (qr, workers, to_be_checked, &exceeded) :
+            find_and_mark_blocked_clauses_parallel
+            (qr, workers, to_be_checked, &exceeded);
+          if (cnt)
             {
-              if (qr->options.verbosity >= 2)
-                {
-                  fprintf (stderr, "\nRedundancy check on clause ");
-                  print_lits (qr, stderr, c->lits, c->num_lits, 1);
-                }
-
-              qr->cnt_qbce_checks++;
-              /* Print progress information. */
-              if (qr->options.verbosity >= 1 && 
-                  (qr->cnt_qbce_checks & ((1 << 15) - 1)) == 0)
-                fprintf (stderr, "progress -- clause checks: %llu\n", 
-                         qr->cnt_qbce_checks);
-              /* Periodically check if soft time limit reached, exit for-loop. */
-              if ((qr->cnt_qbce_checks &
-                   ((1 << QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD) - 1)) == 0 &&
-                  (exceeded = exceeded_soft_time_limit (qr)))
-                {
-                  fprintf (stderr, "Exceeded soft time limit of %u sec after %llu clause checks\n",
-                           qr->soft_time_limit, qr->cnt_qbce_checks);
-                  continue;
-                }
-              if ( (mode == QRATPLUS_CHECK_MODE_QBCE && is_clause_blocked (qr, c)) ||
-                   (mode == QRATPLUS_CHECK_MODE_AT && qrat_qat_check (qr, c)) ||
-                   (mode == QRATPLUS_CHECK_MODE_QRAT && has_clause_qrat (qr, c)) )
-                {
-                  if (qr->options.verbosity >= 2)
-                    {
-                      fprintf (stderr, "  ==> Clause ");
-                      print_lits (qr, stderr, c->lits, c->num_lits, 1);
-                      fprintf (stderr, " is redundant.\n");
-                    }
-                  c->redundant = 1;
-                  PUSH_STACK (qr->mm, qr->redundant_clauses, c);
-                  cur_redundant_clauses++;
-                  changed = 1;
-                  result = 1;
-                }
+              cur_redundant_clauses += cnt;
+              changed = 1;
+              result = 1;
             }
         }
+      else
+        for (cp = to_be_checked->start, ce = to_be_checked->top;
+             !exceeded && cp < ce; cp++)
+          {
+            Clause *c = *cp;
+            assert (!qr->options.ignore_outermost_vars ||
+                    !clause_has_outermost_qblock_literal (qr, c));
+          
+            /* NOTE: we may encounter clauses 'c' with 'c->redundant' true
+               because such clauses may appear on 'rescheduled' (see comment above)
+               and we just swap the sets at the beginning of each iteration. */
+            if (!c->redundant)
+              {
+                if (QRATPREPLUS_TRACE (qr))
+                  {
+                    fprintf (stderr, "\nRedundancy check on clause ");
+                    print_lits (qr, stderr, c->lits, c->num_lits, 1);
+                  }
+
+                qr->cnt_qbce_checks++;
+                /* Print progress information. */
+                if (qr->options.verbosity >= 1 && 
+                    (qr->cnt_qbce_checks & ((1 << 15) - 1)) == 0)
+                  fprintf (stderr, "progress -- clause checks: %llu\n", 
+                           qr->cnt_qbce_checks);
+                /* Periodically check if soft time limit reached, exit for-loop. */
+                if ((qr->cnt_qbce_checks &
+                     ((1 << QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD) - 1)) == 0 &&
+                    (exceeded = exceeded_soft_time_limit (qr)))
+                  {
+                    fprintf (stderr, "Exceeded soft time limit of %u sec after %llu clause checks\n",
+                             qr->soft_time_limit, qr->cnt_qbce_checks);
+                    continue;
+                  }
+                if ( (mode == QRATPLUS_CHECK_MODE_QBCE && is_clause_blocked (qr, c)) ||
+                     (mode == QRATPLUS_CHECK_MODE_AT && qrat_qat_check (qr, c)) ||
+                     (mode == QRATPLUS_CHECK_MODE_QRAT && has_clause_qrat (qr, c)) )
+                  {
+                    if (QRATPREPLUS_TRACE (qr))
+                      {
+                        fprintf (stderr, "  ==> Clause ");
+                        print_lits (qr, stderr, c->lits, c->num_lits, 1);
+                        fprintf (stderr, " is redundant.\n");
+                      }
+                    c->redundant = 1;
+                    PUSH_STACK (qr->mm, qr->redundant_clauses, c);
+                    cur_redundant_clauses++;
+                    changed = 1;
+                    result = 1;
+                  }
+              }
+          }
 
       /* Do not reschedule from incomplete iterations of above for-loop. */
       if (exceeded)
@@ -692,12 +1904,32 @@ find_and_mark_redundant_clauses_aux (QRATPrePlus * qr,
       /* Reschedule from redundant witness clauses in QBCE/QRAT mode. */
       if (mode != QRATPLUS_CHECK_MODE_AT)
         reschedule_from_redundant_witness_clauses (qr, rescheduled);
+
+      if (changed && stop_phase_on_diminishing_returns
+          (qr, phase_name, &first_rate, cur_redundant_clauses,
+           iteration_start, COUNT_STACK (*to_be_checked), rescheduled))
+        {
+          cutoff = 1;
+          break;
+        }
     }
 
-  /* Must update statistics after exiting loop due to exceeding time limit. */
-  assert (exceeded || cur_redundant_clauses == 0);
+  /* Must update statistics after exiting loop due to exceeding time limit
+     or diminishing returns. */
+  assert (exceeded || cutoff || cur_redundant_clauses == 0);
   qr->cnt_redundant_clauses += cur_redundant_clauses;
 
+  qr->workers = 0;
+  if (workers)
+    delete_workers (qr, workers);
+  if (speculative)
+    {
+      mm_free (qr->mm, work.results,
+               QRATPLUS_SPECULATION_WINDOW * sizeof (CheckResult));
+      mm_free (qr->mm, work.clauses_by_id,
+               (qr->cur_clause_id + 1) * sizeof (Clause *));
+    }
+
 #ifndef NDEBUG
   Clause *c;
   for (c = qr->pcnf.clauses.first; c; c = c->link.next)
@@ -707,14 +1939,27 @@ find_and_mark_redundant_clauses_aux (QRATPrePlus * qr,
   return result;
 }
 
+/* Remove redundant clauses and stale entries from occurrences 'occs' of
+   literal 'lit'. */
 static void
-unlink_redundant_clauses_occs (QRATPrePlus * qr, ClausePtrStack *occs)
+unlink_redundant_clauses_occs (QRATPrePlus * qr, ClausePtrStack *occs,
+                               LitID lit)
 {
   Clause **cp, **ce;
+  if (qr->options.occ_order != OCC_ORDER_NONE)
+    {
+      /* Keep the ordering of the remaining occurrences. */
+      Clause **to = occs->start;
+      for (cp = occs->start, ce = occs->top; cp < ce; cp++)
+        if (!(*cp)->redundant && !is_stale_occ (qr, *cp, lit))
+          *to++ = *cp;
+      occs->top = to;
+      return;
+    }
   for (cp = occs->start, ce = occs->top; cp < ce; cp++)
     {
       Clause *c = *cp;
-      if (c->redundant)
+      if (c->redundant || is_stale_occ (qr, c, lit))
         {
           Clause *last = POP_STACK (*occs);
           *cp = last;
@@ -724,6 +1969,18 @@ unlink_redundant_clauses_occs (QRATPrePlus * qr, ClausePtrStack *occs)
     }
 }
 
+/* Collect 'var' on 'qr->dirty_vars' for removing redundant clauses and
+   stale entries from its occurrences. */
+static void
+collect_dirty_var (QRATPrePlus * qr, Var *var)
+{
+  if (!var->dirty)
+    {
+      var->dirty = 1;
+      PUSH_STACK (qr->mm, qr->dirty_vars, var);
+    }
+}
+
 static void
 remove_clause_from_occs (ClausePtrStack *occs, Clause *c)
 {
@@ -775,10 +2032,19 @@ cleanup_redundant_universal_literal (QRATPrePlus * qr, Clause * c, LitID red_lit
       c->rw_index = WATCHED_LIT_INVALID_INDEX;
     }
 
-  /* Remove clause 'c' from occs of variable of 'red_lit'. */
+  /* Keep 'c' as a stale entry on the occs of the variable of 'red_lit'
+     rather than searching it. Stale entries are removed in batches by
+     'unlink_redundant_clauses'. */
   ClausePtrStack *occs = LIT_NEG (red_lit) ? 
     &red_var->neg_occ_clauses : &red_var->pos_occ_clauses;
-  remove_clause_from_occs (occs, c);
+  unsigned int old_cnt = count_occs (red_var, occs);
+  if (LIT_NEG (red_lit))
+    red_var->cnt_stale_neg_occs++;
+  else
+    red_var->cnt_stale_pos_occs++;
+  collect_dirty_var (qr, red_var);
+  update_occ_limit_marks (qr, red_var, occs, old_cnt);
+  qr->total_occ_cnts--;
 
   assert (count_qtype_literals (qr, c, QTYPE_FORALL) + 
           count_qtype_literals (qr, c, QTYPE_EXISTS) == c->num_lits);
@@ -804,11 +2070,20 @@ cleanup_redundant_universal_literal (QRATPrePlus * qr, Clause * c, LitID red_lit
           LitID *to, *from;
           for (to = p, from = p + 1; from < e; to++, from++)
             *to = *from;
+          /* Shift nesting levels accordingly. */
+          Nesting *nestings = CLAUSE_NESTINGS (c);
+          unsigned int i;
+          for (i = p - c->lits; i + 1 < c->num_lits; i++)
+            nestings[i] = nestings[i + 1];
 	  break;
         }
     }
 
   c->num_lits--;
+  c->sig = compute_signature (c->lits, c->lits + c->num_lits);
+  qr->total_clause_lengths--;
+  if (c->exceeds_occ_limit)
+    c->exceeds_occ_limit = clause_exceeds_occ_limit (qr, c);
 
   if (c->num_lits == 1)
     PUSH_STACK (qr->mm, qr->unit_input_clauses, c);
@@ -841,11 +2116,99 @@ cleanup_redundant_universal_literal (QRATPrePlus * qr, Clause * c, LitID red_lit
     }
 }
 
-/* Return nonzero iff clause 'c' contains universal literals which have QRAT. */
+/* Collect the variable of 'lit' on 'changed_vars' unless it was already
+   collected. Collected variables are marked. */
+static void
+collect_changed_var (QRATPrePlus * qr, VarPtrStack *changed_vars, LitID lit)
+{
+  Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+  if (!VAR_POS_MARKED (var))
+    {
+      VAR_POS_MARK (var);
+      PUSH_STACK (qr->mm, *changed_vars, var);
+    }
+}
+
+/* Collect the variables of the literals in clause 'c', from which
+   redundant literals were removed, on 'changed_vars'. */
+static void
+collect_changed_vars_of_clause (QRATPrePlus * qr, VarPtrStack *changed_vars,
+                                Clause * c)
+{
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    collect_changed_var (qr, changed_vars, *p);
+}
+
+/* Collect all non-redundant and not already collected clauses on stack
+   'rescheduled' that contain a variable on 'changed_vars' and unmark the
+   variables. These are the clauses that share a variable with a clause
+   from which redundant literals were removed, i.e., clauses whose
+   resolution partners changed. */
+static void
+reschedule_from_changed_vars (QRATPrePlus * qr, VarPtrStack *changed_vars,
+                              ClausePtrStack *rescheduled)
+{
+  Var **vp, **ve;
+  for (vp = changed_vars->start, ve = changed_vars->top; vp < ve; vp++)
+    {
+      Var *var = *vp;
+      assert (VAR_POS_MARKED (var));
+      VAR_UNMARK (var);
+      unsigned int neg;
+      for (neg = 0; neg <= 1; neg++)
+        {
+          ClausePtrStack *occs = neg ?
+            &var->neg_occ_clauses : &var->pos_occ_clauses;
+          LitID lit = neg ? -(LitID) var->id : (LitID) var->id;
+          Clause *oc, **cp, **ce;
+          for (cp = occs->start, ce = occs->top; cp < ce; cp++)
+            {
+              oc = *cp;
+              if (!oc->redundant && !oc->rescheduled &&
+                  !is_stale_occ (qr, oc, lit) &&
+                  reschedule_is_clause_within_limits (qr, oc))
+                {
+                  oc->rescheduled = 1;
+                  PUSH_STACK (qr->mm, *rescheduled, oc);
+                  if (QRATPREPLUS_TRACE (qr))
+                    {
+                      fprintf (stderr, "    rescheduled clause: ");
+                      print_lits (qr, stderr, oc->lits, oc->num_lits, 1);
+                    }
+                }
+            }
+        }
+    }
+  RESET_STACK (*changed_vars);
+}
+
+/* Collect the variables on 'changed_vars' on 'qr->touched_vars' for
+   scheduling clauses in the next global iteration. */
+static void
+collect_touched_vars (QRATPrePlus * qr, VarPtrStack *changed_vars)
+{
+  Var **vp, **ve;
+  for (vp = changed_vars->start, ve = changed_vars->top; vp < ve; vp++)
+    {
+      Var *var = *vp;
+      if (!var->touched)
+        {
+          var->touched = 1;
+          PUSH_STACK (qr->mm, qr->touched_vars, var);
+        }
+    }
+}
+
+/* Return nonzero iff clause 'c' contains universal literals which have
+   QRAT. The variables of removed literals are collected on
+   'changed_vars'. */
 static int
-has_clause_qrat_literals (QRATPrePlus * qr, Clause * c)
+has_clause_qrat_literals (QRATPrePlus * qr, Clause * c,
+                          VarPtrStack *changed_vars)
 {
   assert (!c->redundant);
+  qr->cur_resolvents = 0;
   int result = 0;
   LitID *p, *e;
   for (p = c->lits, e = p + c->num_lits; p < e; p++)
@@ -857,12 +2220,13 @@ has_clause_qrat_literals (QRATPrePlus * qr, Clause * c)
         {
           if (has_qrat_on_literal (qr, c, lit))
             {
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 {
                   fprintf (stderr, "  ==> universal literal %d has QRAT in clause ", lit);
                   print_lits (qr, stderr, c->lits, c->num_lits, 1);
                 }
               cleanup_redundant_universal_literal (qr, c, lit);
+              collect_changed_var (qr, changed_vars, lit);
               result = 1;
               /* Must update pointers since removed redundant 'lit' from 'c'. */
               p--;
@@ -873,12 +2237,15 @@ has_clause_qrat_literals (QRATPrePlus * qr, Clause * c)
   return result;
 }
 
-/* Return nonzero iff clause 'c' contains blocked universal literals. */
+/* Return nonzero iff clause 'c' contains blocked universal literals. The
+   variables of removed literals are collected on 'changed_vars'. */
 static int
-has_clause_blocked_literals (QRATPrePlus * qr, Clause * c)
+has_clause_blocked_literals (QRATPrePlus * qr, Clause * c,
+                             VarPtrStack *changed_vars)
 {
   int result = 0;
   assert (!c->redundant);
+  qr->cur_resolvents = 0;
   LitID *p, *e;
   for (p = c->lits, e = p + c->num_lits; p < e; p++)
     {
@@ -889,12 +2256,13 @@ has_clause_blocked_literals (QRATPrePlus * qr, Clause * c)
         {
           if (is_literal_blocked (qr, c, lit))
             {
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 {
                   fprintf (stderr, "  ==> universal literal %d is blocked in clause ", lit);
                   print_lits (qr, stderr, c->lits, c->num_lits, 1);
                 }
               cleanup_redundant_universal_literal (qr, c, lit);
+              collect_changed_var (qr, changed_vars, lit);
               result = 1;
               /* Must update pointers since removed redundant 'lit' from 'c'. */
               p--;
@@ -905,39 +2273,252 @@ has_clause_blocked_literals (QRATPrePlus * qr, Clause * c)
   return result;
 }
 
-/* Returns nonzero iff redundant literals were found. */
-static int
-find_and_delete_redundant_literals_aux (QRATPrePlus * qr, 
-                                     ClausePtrStack *to_be_checked, 
-                                     ClausePtrStack *rescheduled, 
-                                     const QRATPlusCheckMode mode)
-{  
-  int result = 0;
-  assert (!qr->options.no_ble || !qr->options.no_qratu);
-  assert (mode == QRATPLUS_CHECK_MODE_QBCE || mode == QRATPLUS_CHECK_MODE_QRAT);
-  assert (mode != QRATPLUS_CHECK_MODE_QBCE || !qr->options.no_ble);
-  assert (mode != QRATPLUS_CHECK_MODE_QRAT || !qr->options.no_qratu);
-  assert (EMPTY_STACK (qr->witness_clauses));
-
-  int exceeded = 0;
-
-  if ((exceeded = exceeded_soft_time_limit (qr)))
-    fprintf (stderr, "Exceeded soft time limit of %u sec\n", qr->soft_time_limit);
+/* Remove the literal at position 'pos' from clause 'c', which must not be
+   part of any occurrence or watched literal list. */
+static void
+remove_literal_from_unlinked_clause (Clause * c, unsigned int pos)
+{
+  assert (pos < c->num_lits);
+  Nesting *nestings = CLAUSE_NESTINGS (c);
+  unsigned int i;
+  for (i = pos; i + 1 < c->num_lits; i++)
+    {
+      c->lits[i] = c->lits[i + 1];
+      nestings[i] = nestings[i + 1];
+    }
+  c->num_lits--;
+  c->sig = compute_signature (c->lits, c->lits + c->num_lits);
+}
 
-#ifndef NDEBUG
-  {
-    /* Clauses to be tested are expected to be sorted by ID. */
-    Clause **cp, **ce, **cpprev;
-    for (cp = cpprev = rescheduled->start, ce = rescheduled->top; cp < ce; cp++)
+/* Thread function of a worker: check the universal literals of clauses
+   claimed from the shared work list for QRAT on the private copy of the
+   formula. The copy is not modified. Instead, each clause is checked on a
+   scratch copy of the clause, from which literals found redundant are
+   removed like in 'has_clause_qrat_literals', while the clause itself is
+   ignored in QBCP. The removed literals are recorded in the result. */
+static void *
+run_qratu_worker (void *arg)
+{
+  Worker *w = (Worker *) arg;
+  QRATPrePlus *qr = &w->qr;
+  WorkList *work = w->work;
+  unsigned int i, e;
+  while (claim_chunk (work, &i, &e))
+    for (; i < e; i++)
       {
-        Clause *c = *cp;
-        Clause *cprev = *cpprev;
-        assert (cprev->id <= c->id);
-        cpprev = cp;     
-      }
+        Clause *c = w->clones[work->clauses[i]->id];
+        CheckResult *r = work->results + i;
+        r->worker = w;
+        r->removed_start = r->removed_end = COUNT_STACK (w->removed_lits);
+        if (!c || c->redundant)
+          {
+            r->checked = 1;
+            continue;
+          }
+        if (worker_exceeded_soft_time_limit (qr, work, &qr->cnt_qratu_checks))
+          break;
+
+        Clause *scratch = mm_malloc (qr->mm, CLAUSE_BYTES (c->size_lits));
+        memcpy (scratch, c, CLAUSE_BYTES (c->size_lits));
+        c->ignore_in_qbcp = 1;
+        qr->cur_resolvents = 0;
+        unsigned int pos = 0;
+        while (pos < scratch->num_lits)
+          {
+            LitID lit = scratch->lits[pos];
+            Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+            if (var->qblock->type == QTYPE_FORALL &&
+                has_qrat_on_literal (qr, scratch, lit))
+              {
+                PUSH_STACK (qr->mm, w->removed_lits, lit);
+                remove_literal_from_unlinked_clause (scratch, pos);
+              }
+            else
+              pos++;
+          }
+        c->ignore_in_qbcp = 0;
+        mm_free (qr->mm, scratch, CLAUSE_BYTES (scratch->size_lits));
+        reset_used_clauses (qr);
+
+        r->removed_end = COUNT_STACK (w->removed_lits);
+        r->redundant = r->removed_end > r->removed_start;
+        r->checked = 1;
+      }
+  return 0;
+}
+
+/* Remove the literals found redundant in clause 'c' according to result
+   'r' from 'c' and from the copies of 'c' of all workers. The variables of
+   removed literals are collected on 'changed_vars'. */
+static void
+commit_redundant_literals (QRATPrePlus * qr, Worker *workers, Clause *c,
+                           CheckResult *r, VarPtrStack *changed_vars)
+{
+  unsigned int i, num_workers = qr->options.threads;
+  Worker *w = r->worker;
+  LitID *p, *e;
+  for (p = w->removed_lits.start + r->removed_start,
+         e = w->removed_lits.start + r->removed_end; p < e; p++)
+    {
+      if (QRATPREPLUS_TRACE (qr))
+        {
+          fprintf (stderr, "  ==> universal literal %d has QRAT in clause ", *p);
+          print_lits (qr, stderr, c->lits, c->num_lits, 1);
+        }
+      cleanup_redundant_universal_literal (qr, c, *p);
+      collect_changed_var (qr, changed_vars, *p);
+      for (i = 0; i < num_workers; i++)
+        cleanup_redundant_universal_literal (&workers[i].qr,
+                                             workers[i].clones[c->id], *p);
+    }
+}
+
+/* Check the universal literals of all clauses on 'to_be_checked' for QRAT
+   using 'qr->options.threads' workers. Workers check the clauses of a
+   window speculatively on private copies of the formula. Results are
+   committed in the order of 'to_be_checked' up to the first clause from
+   which literals are removed. Then all copies are updated and the
+   remaining results of the window are discarded, since removing literals
+   strengthens the formula and may change the result of any later check,
+   and checking continues with a new window. Hence the redundant literals
+   found are exactly the same as in sequential checking. The variables of
+   clauses from which literals were removed are collected on
+   'changed_vars'. Sets 'exceeded' if the soft time limit was
+   exceeded. Returns the number of removed literals. */
+static unsigned int
+find_and_delete_redundant_literals_speculative (QRATPrePlus * qr,
+                                                Worker *workers,
+                                                ClausePtrStack *to_be_checked,
+                                                VarPtrStack *changed_vars,
+                                                int *exceeded)
+{
+  unsigned int i, num_workers = qr->options.threads;
+  WorkList *work = workers[0].work;
+  unsigned int result = 0;
+  unsigned int min_window = num_workers * QRATPLUS_SPECULATIVE_CHUNK_SIZE;
+  unsigned int window = QRATPLUS_SPECULATION_WINDOW;
+  unsigned int window_start = 0, cnt = COUNT_STACK (*to_be_checked);
+
+  if (min_window > QRATPLUS_SPECULATION_WINDOW)
+    min_window = QRATPLUS_SPECULATION_WINDOW;
+
+  while (!*exceeded && window_start < cnt)
+    {
+      work->clauses = to_be_checked->start + window_start;
+      work->cnt = cnt - window_start < window ? cnt - window_start : window;
+      work->next = 0;
+      work->chunk_size = QRATPLUS_SPECULATIVE_CHUNK_SIZE;
+      work->exceeded = 0;
+      memset (work->results, 0, work->cnt * sizeof (CheckResult));
+      for (i = 0; i < num_workers; i++)
+        RESET_STACK (workers[i].removed_lits);
+
+      run_workers (qr, workers, run_qratu_worker);
+
+      /* Commit results in order up to the first clause with redundant
+         literals, stop at first clause not checked due to time limit. */
+      int removed = 0;
+      for (i = 0; !removed && i < work->cnt; i++)
+        {
+          Clause *c = work->clauses[i];
+          CheckResult *r = work->results + i;
+          if (!r->checked)
+            {
+              *exceeded = 1;
+              break;
+            }
+          if (r->redundant)
+            {
+              unsigned int num_lits_before = c->num_lits;
+              commit_redundant_literals (qr, workers, c, r, changed_vars);
+              collect_changed_vars_of_clause (qr, changed_vars, c);
+              if (QRATPREPLUS_TRACE (qr))
+                {
+                  fprintf (stderr, "  ==> Redundant universal literals removed from clause ");
+                  print_lits (qr, stderr, c->lits, c->num_lits, 1);
+                  fprintf (stderr, "\n");
+                }
+              result += num_lits_before - c->num_lits;
+              removed = 1;
+            }
+        }
+      window_start += i;
+
+      if (removed)
+        {
+          for (; i < work->cnt; i++)
+            if (work->results[i].checked)
+              qr->cnt_speculative_qratu_discards++;
+          window = window / 2 < min_window ? min_window : window / 2;
+        }
+      else if (window < QRATPLUS_SPECULATION_WINDOW)
+        window *= 2;
+
+      for (i = 0; i < num_workers; i++)
+        merge_worker_stats (qr, workers + i);
+    }
+
+  if (*exceeded)
+    fprintf (stderr, "Exceeded soft time limit of %u sec after %llu literal redundancy clause checks\n",
+             qr->soft_time_limit, qr->cnt_qratu_checks);
+  return result;
+}
+
+/* Returns nonzero iff redundant literals were found. */
+static int
+find_and_delete_redundant_literals_aux (QRATPrePlus * qr, 
+                                     ClausePtrStack *to_be_checked, 
+                                     ClausePtrStack *rescheduled, 
+                                     const QRATPlusCheckMode mode)
+{  
+  int result = 0;
+  assert (!qr->options.no_ble || !qr->options.no_qratu);
+  assert (mode == QRATPLUS_CHECK_MODE_QBCE || mode == QRATPLUS_CHECK_MODE_QRAT);
+  assert (mode != QRATPLUS_CHECK_MODE_QBCE || !qr->options.no_ble);
+  assert (mode != QRATPLUS_CHECK_MODE_QRAT || !qr->options.no_qratu);
+  assert (EMPTY_STACK (qr->witness_clauses));
+
+  int exceeded = 0;
+
+  if ((exceeded = exceeded_soft_time_limit (qr)))
+    fprintf (stderr, "Exceeded soft time limit of %u sec\n", qr->soft_time_limit);
+
+#ifndef NDEBUG
+  {
+    /* Clauses to be tested are expected to be sorted by ID. */
+    Clause **cp, **ce, **cpprev;
+    for (cp = cpprev = rescheduled->start, ce = rescheduled->top; cp < ce; cp++)
+      {
+        Clause *c = *cp;
+        Clause *cprev = *cpprev;
+        assert (cprev->id <= c->id);
+        cpprev = cp;     
+      }
   }
 #endif
 
+  /* Check clauses speculatively in QRATU mode if multiple threads are
+     enabled. BLE is cheap and always done sequentially. As in QRATE, a
+     QBCP propagation limit may make results differ from sequential
+     checks. */
+  WorkList work;
+  memset (&work, 0, sizeof (work));
+  Worker *workers = 0;
+  if (mode == QRATPLUS_CHECK_MODE_QRAT && qr->options.threads > 1 &&
+      (!qr->options.deterministic || qr->limit_qbcp_cur_props == UINT_MAX))
+    {
+      work.results = mm_malloc (qr->mm, QRATPLUS_SPECULATION_WINDOW *
+                                sizeof (CheckResult));
+      workers = create_workers (qr, &work, 1);
+    }
+
+  /* Variables of clauses from which literals were removed in the current
+     iteration. */
+  VarPtrStack changed_vars;
+  INIT_STACK (changed_vars);
+
+  const char *phase_name = mode == QRATPLUS_CHECK_MODE_QBCE ? "BLE" : "QRATU";
+  double first_rate = -1;
   unsigned int cur_redundant_literals = 0;
   int changed = 1;
   while (!exceeded && changed)
@@ -945,6 +2526,7 @@ find_and_delete_redundant_literals_aux (QRATPrePlus * qr,
       /* Statistics. */
       qr->cnt_redundant_literals += cur_redundant_literals;
       qr->cnt_qratu_iterations++;
+      double iteration_start = wall_time_stamp ();
 
       /* Set up new iteration: swap 'rescheduled' and 'to_be_checked', reset. */
       changed = 0;
@@ -966,7 +2548,7 @@ find_and_delete_redundant_literals_aux (QRATPrePlus * qr,
       if (qr->options.verbosity >= 1)
         {
           fprintf (stderr, "\n======\n%s iteration %d: %d new redundant literals in previous iteration %d\n", 
-                   mode == QRATPLUS_CHECK_MODE_QBCE ? "BLE" : "QRATU",
+                   phase_name,
                    qr->cnt_qratu_iterations, cur_redundant_literals, qr->cnt_qratu_iterations - 1);
           fprintf (stderr, "Clauses to be checked (worst case): %u ( %f %% of original CNF)\n======\n", 
                    (unsigned int) COUNT_STACK (*to_be_checked), 100 * (COUNT_STACK (*to_be_checked) / (float) qr->actual_num_clauses));
@@ -981,69 +2563,108 @@ find_and_delete_redundant_literals_aux (QRATPrePlus * qr,
       if (mode != QRATPLUS_CHECK_MODE_QBCE && qr->options.permute)
         permute_clauses_to_be_checked (qr, to_be_checked);
       else
-        qsort (to_be_checked->start, COUNT_STACK (*to_be_checked), 
-               sizeof (Clause *), compare_clauses_by_id);
+        sort_clauses_to_be_checked (qr, to_be_checked);
 
-      for (cp = to_be_checked->start, ce = to_be_checked->top; 
-           !exceeded && cp < ce; cp++)
+      if (workers)
         {
-          Clause *c = *cp;
-          assert (!qr->options.ignore_outermost_vars ||
-                  !clause_has_outermost_qblock_literal (qr, c));
-
-          /* NOTE: we may encounter clauses 'c' with 'c->redundant' true
-             because such clauses may appear on 'rescheduled' (see comment above)
-             and we just swap the sets at the beginning of each iteration. */
-          if (!c->redundant)
+          unsigned int cnt = find_and_delete_redundant_literals_speculative
+            (qr, workers, to_be_checked, &changed_vars, &exceeded);
+          if (cnt)
             {
-              if (qr->options.verbosity >= 2)
-                {
-                  fprintf (stderr, "\nLiteral redundancy check on clause ");
-                  print_lits (qr, stderr, c->lits, c->num_lits, 1);
-                }
-              
-              qr->cnt_qratu_checks++;
-              /* Print progress information. */
-              if (qr->options.verbosity >= 1 && 
-                  (qr->cnt_qratu_checks & ((1 << 15) - 1)) == 0)
-                fprintf (stderr, "progress -- literal redundancy clause checks: %llu\n", 
-                         qr->cnt_qratu_checks);
-              /* Periodically check if soft time limit reached, exit for-loop. */
-              if ((qr->cnt_qratu_checks &
-                   ((1 << QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD) - 1)) == 0 &&
-                  (exceeded = exceeded_soft_time_limit (qr)))
-                {
-                  fprintf (stderr, "Exceeded soft time limit of %u sec after %llu literal redundancy clause checks\n",
-                           qr->soft_time_limit, qr->cnt_qratu_checks);
-                  continue;
-                }
-              unsigned int num_lits_before = c->num_lits;
-              if ( (mode == QRATPLUS_CHECK_MODE_QBCE && has_clause_blocked_literals (qr, c)) ||
-                   (mode == QRATPLUS_CHECK_MODE_QRAT && has_clause_qrat_literals (qr, c)) )
-                {
-                  assert (c->num_lits > 0);
-                  assert (num_lits_before > c->num_lits);
-                  if (qr->options.verbosity >= 2)
-                    {
-                      fprintf (stderr, "  ==> Redundant universal literals removed from clause ");
-                      print_lits (qr, stderr, c->lits, c->num_lits, 1);
-                      fprintf (stderr, "\n");
-                    }
-                  cur_redundant_literals += (num_lits_before - c->num_lits);
-                  changed = 1;
-                  result = 1;
-                }
+              cur_redundant_literals += cnt;
+              changed = 1;
+              result = 1;
             }
         }
+      else
+        for (cp = to_be_checked->start, ce = to_be_checked->top; 
+             !exceeded && cp < ce; cp++)
+          {
+            Clause *c = *cp;
+            assert (!qr->options.ignore_outermost_vars ||
+                    !clause_has_outermost_qblock_literal (qr, c));
+
+            /* NOTE: we may encounter clauses 'c' with 'c->redundant' true
+               because such clauses may appear on 'rescheduled' (see comment above)
+               and we just swap the sets at the beginning of each iteration. */
+            if (!c->redundant)
+              {
+                if (QRATPREPLUS_TRACE (qr))
+                  {
+                    fprintf (stderr, "\nLiteral redundancy check on clause ");
+                    print_lits (qr, stderr, c->lits, c->num_lits, 1);
+                  }
+              
+                qr->cnt_qratu_checks++;
+                /* Print progress information. */
+                if (qr->options.verbosity >= 1 && 
+                    (qr->cnt_qratu_checks & ((1 << 15) - 1)) == 0)
+                  fprintf (stderr, "progress -- literal redundancy clause checks: %llu\n", 
+                           qr->cnt_qratu_checks);
+                /* Periodically check if soft time limit reached, exit for-loop. */
+                if ((qr->cnt_qratu_checks &
+                     ((1 << QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD) - 1)) == 0 &&
+                    (exceeded = exceeded_soft_time_limit (qr)))
+                  {
+                    fprintf (stderr, "Exceeded soft time limit of %u sec after %llu literal redundancy clause checks\n",
+                             qr->soft_time_limit, qr->cnt_qratu_checks);
+                    continue;
+                  }
+                unsigned int num_lits_before = c->num_lits;
+                if ( (mode == QRATPLUS_CHECK_MODE_QBCE &&
+                      has_clause_blocked_literals (qr, c, &changed_vars)) ||
+                     (mode == QRATPLUS_CHECK_MODE_QRAT &&
+                      has_clause_qrat_literals (qr, c, &changed_vars)) )
+                  {
+                    collect_changed_vars_of_clause (qr, &changed_vars, c);
+                    assert (c->num_lits > 0);
+                    assert (num_lits_before > c->num_lits);
+                    if (QRATPREPLUS_TRACE (qr))
+                      {
+                        fprintf (stderr, "  ==> Redundant universal literals removed from clause ");
+                        print_lits (qr, stderr, c->lits, c->num_lits, 1);
+                        fprintf (stderr, "\n");
+                      }
+                    cur_redundant_literals += (num_lits_before - c->num_lits);
+                    changed = 1;
+                    result = 1;
+                  }
+              }
+          }
 
       /* Do not reschedule from incomplete iterations of above for-loop. */
       if (exceeded)
         continue;
 
-      /* For simplicity: if redundant literals were found in previous
-         iteration, then reschedule ALL non-redundant clauses. */
+      /* If redundant literals were found in previous iteration, then
+         reschedule the clauses sharing a variable with a clause from which
+         literals were removed. */
       if (changed)
-        reschedule_from_input_clauses (qr, rescheduled);
+        {
+          collect_touched_vars (qr, &changed_vars);
+          reschedule_from_changed_vars (qr, &changed_vars, rescheduled);
+
+          if (stop_phase_on_diminishing_returns
+              (qr, phase_name, &first_rate, cur_redundant_literals,
+               iteration_start, COUNT_STACK (*to_be_checked), rescheduled))
+            {
+              qr->cnt_redundant_literals += cur_redundant_literals;
+              break;
+            }
+        }
+    }
+
+  /* Unmark variables collected in an incomplete iteration. */
+  Var **vp, **ve;
+  for (vp = changed_vars.start, ve = changed_vars.top; vp < ve; vp++)
+    VAR_UNMARK (*vp);
+  DELETE_STACK (qr->mm, changed_vars);
+
+  if (workers)
+    {
+      delete_workers (qr, workers);
+      mm_free (qr->mm, work.results,
+               QRATPLUS_SPECULATION_WINDOW * sizeof (CheckResult));
     }
 
 #ifndef NDEBUG
@@ -1056,49 +2677,492 @@ find_and_delete_redundant_literals_aux (QRATPrePlus * qr,
 }
 
 
+/* Check of clause 'clause' by technique 'technique' in the priority
+   schedule. Tasks of a technique with smaller 'key' are checked first. */
+typedef struct Task Task;
+struct Task
+{
+  Clause *clause;
+  double key;
+  double cost;
+  QRATPlusTechnique technique;
+};
+
+DECLARE_STACK (Task, Task);
+
+/* Priority queues of tasks and success history of the techniques. */
+typedef struct Scheduler Scheduler;
+struct Scheduler
+{
+  /* Binary min-heaps of tasks, one per technique. */
+  TaskStack heaps[QRATPLUS_NUM_TECHNIQUES];
+  /* Techniques queued for each clause, indexed by clause ID. */
+  unsigned char *queued;
+  /* Techniques enabled by the options. */
+  unsigned int enabled;
+  long long unsigned int attempts[QRATPLUS_NUM_TECHNIQUES];
+  long long unsigned int successes[QRATPLUS_NUM_TECHNIQUES];
+  /* Variables of clauses from which literals were removed. */
+  VarPtrStack changed_vars;
+  /* Techniques for which all clauses are scheduled once no tasks are
+     left, which corresponds to a new global iteration. */
+  unsigned int full_reschedule;
+};
+
+static const char *technique_names[QRATPLUS_NUM_TECHNIQUES] =
+  { "QBCE", "AT", "QRATE", "BLE", "QRATU" };
+
+/* Returns nonzero iff task 'a' must be checked before task 'b'. Ties are
+   broken by clause ID, hence the schedule is deterministic. */
+static int
+task_before (Task *a, Task *b)
+{
+  if (a->key != b->key)
+    return a->key < b->key;
+  return a->clause->id < b->clause->id;
+}
+
+static void
+push_task (QRATPrePlus * qr, TaskStack *heap_stack, Task task)
+{
+  PUSH_STACK (qr->mm, *heap_stack, task);
+  Task *heap = heap_stack->start;
+  unsigned int i = COUNT_STACK (*heap_stack) - 1;
+  while (i > 0 && task_before (&task, heap + (i - 1) / 2))
+    {
+      heap[i] = heap[(i - 1) / 2];
+      i = (i - 1) / 2;
+    }
+  heap[i] = task;
+}
+
+static Task
+pop_task (TaskStack *heap_stack)
+{
+  assert (!EMPTY_STACK (*heap_stack));
+  Task *heap = heap_stack->start;
+  Task result = heap[0];
+  Task last = POP_STACK (*heap_stack);
+  unsigned int i = 0, cnt = COUNT_STACK (*heap_stack);
+  if (cnt == 0)
+    return result;
+  while (2 * i + 1 < cnt)
+    {
+      unsigned int child = 2 * i + 1;
+      if (child + 1 < cnt && task_before (heap + child + 1, heap + child))
+        child++;
+      if (!task_before (heap + child, &last))
+        break;
+      heap[i] = heap[child];
+      i = child;
+    }
+  heap[i] = last;
+  return result;
+}
+
+/* Estimate the cost of checking clause 'c' by 'technique' from the length
+   of 'c' and the numbers of occurrences of the complementary literals of
+   the pivots, i.e., the number of resolvents to be checked. Checking a
+   resolvent is a tautology check in QBCE and BLE and a QBCP call in QRATE
+   and QRATU. An AT check is a single QBCP call. */
+static double
+estimate_task_cost (QRATPrePlus * qr, Clause *c, QRATPlusTechnique technique)
+{
+  if (technique == QRATPLUS_TECHNIQUE_AT)
+    return c->num_lits + QRATPLUS_PRIORITY_QBCP_COST;
+
+  QuantifierType pivot_type = (technique == QRATPLUS_TECHNIQUE_BLE ||
+                               technique == QRATPLUS_TECHNIQUE_QRATU) ?
+    QTYPE_FORALL : QTYPE_EXISTS;
+  double resolvents = 0;
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    {
+      Var *var = LIT2VARPTR (qr->pcnf.vars, *p);
+      if (var->qblock->type == pivot_type)
+        resolvents += LIT_NEG (*p) ? count_occs (var, &var->pos_occ_clauses) :
+          count_occs (var, &var->neg_occ_clauses);
+    }
+  if (technique == QRATPLUS_TECHNIQUE_QRATE ||
+      technique == QRATPLUS_TECHNIQUE_QRATU)
+    resolvents *= QRATPLUS_PRIORITY_QBCP_COST;
+  return c->num_lits + resolvents;
+}
+
+/* Schedule checks of clause 'c' by the enabled techniques in 'techniques'
+   that are not already scheduled. QBCE and BLE are confluent, hence their
+   tasks are checked in the order of estimated costs. Since AT, QRATE, and
+   QRATU are not confluent, the order of checks affects the result. Their
+   tasks are checked in the order of clause IDs like in the phases of
+   clause and literal elimination, which avoids eliminating short clauses
+   needed to show the redundancy of longer ones, for example. */
+static void
+schedule_clause (QRATPrePlus * qr, Scheduler *s, Clause *c,
+                 unsigned int techniques)
+{
+  techniques &= s->enabled & ~s->queued[c->id];
+  if (!techniques || c->redundant || !reschedule_is_clause_within_limits (qr, c))
+    return;
+  if (!count_qtype_literals (qr, c, QTYPE_FORALL))
+    techniques &= ~QRATPLUS_LITERAL_TECHNIQUES;
+
+  unsigned int t;
+  for (t = 0; t < QRATPLUS_NUM_TECHNIQUES; t++)
+    if (techniques & QRATPLUS_TECHNIQUE_BIT (t))
+      {
+        Task task;
+        task.clause = c;
+        task.technique = (QRATPlusTechnique) t;
+        task.cost = estimate_task_cost (qr, c, task.technique);
+        task.key = (t == QRATPLUS_TECHNIQUE_QBCE || t == QRATPLUS_TECHNIQUE_BLE) ?
+          task.cost : c->id;
+        s->queued[c->id] |= QRATPLUS_TECHNIQUE_BIT (t);
+        push_task (qr, s->heaps + t, task);
+      }
+}
+
+/* Schedule clauses that may be redundant now that clause 'c' was found
+   redundant: resolution partners on existential literals if 'c' was a
+   witness for the non-redundancy of another clause (see
+   'reschedule_from_redundant_clause') and resolution partners on universal
+   literals for literal elimination. */
+static void
+schedule_from_redundant_clause (QRATPrePlus * qr, Scheduler *s, Clause *c)
+{
+  assert (c->redundant);
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    {
+      Var *var = LIT2VARPTR (qr->pcnf.vars, *p);
+      unsigned int techniques = var->qblock->type == QTYPE_FORALL ?
+        QRATPLUS_LITERAL_TECHNIQUES : (c->witness ?
+                                       QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QBCE) |
+                                       QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QRATE) : 0);
+      if (!techniques)
+        continue;
+      ClausePtrStack *compl_occs = LIT_NEG (*p) ?
+        &var->pos_occ_clauses : &var->neg_occ_clauses;
+      Clause **cp, **ce;
+      for (cp = compl_occs->start, ce = compl_occs->top; cp < ce; cp++)
+        if (!is_stale_occ (qr, *cp, -*p))
+          schedule_clause (qr, s, *cp, techniques);
+    }
+}
+
+/* Schedule all techniques for clauses sharing a variable with a clause
+   from which literals were removed. */
+static void
+schedule_from_changed_vars (QRATPrePlus * qr, Scheduler *s)
+{
+  Var **vp, **ve;
+  for (vp = s->changed_vars.start, ve = s->changed_vars.top; vp < ve; vp++)
+    {
+      Var *var = *vp;
+      assert (VAR_POS_MARKED (var));
+      VAR_UNMARK (var);
+      Clause **cp, **ce;
+      for (cp = var->pos_occ_clauses.start, ce = var->pos_occ_clauses.top;
+           cp < ce; cp++)
+        if (!is_stale_occ (qr, *cp, (LitID) var->id))
+          schedule_clause (qr, s, *cp, QRATPLUS_ALL_TECHNIQUES);
+      for (cp = var->neg_occ_clauses.start, ce = var->neg_occ_clauses.top;
+           cp < ce; cp++)
+        if (!is_stale_occ (qr, *cp, -(LitID) var->id))
+          schedule_clause (qr, s, *cp, QRATPLUS_ALL_TECHNIQUES);
+    }
+  RESET_STACK (s->changed_vars);
+}
+
+/* Select the technique of the next task to be checked. This is the
+   technique where the next task has the smallest estimated cost divided by
+   the success rate of the technique so far. Returns
+   'QRATPLUS_NUM_TECHNIQUES' if no tasks are left. */
+static unsigned int
+select_technique (Scheduler *s)
+{
+  unsigned int t, result = QRATPLUS_NUM_TECHNIQUES;
+  double min_priority = 0;
+  for (t = 0; t < QRATPLUS_NUM_TECHNIQUES; t++)
+    if (!EMPTY_STACK (s->heaps[t]))
+      {
+        double priority = s->heaps[t].start[0].cost *
+          (s->attempts[t] + 2) / (double) (s->successes[t] + 1);
+        if (result == QRATPLUS_NUM_TECHNIQUES || priority < min_priority)
+          {
+            result = t;
+            min_priority = priority;
+          }
+      }
+  return result;
+}
+
+/* Check clause 'c' by technique 't'. Returns nonzero iff 'c' was found
+   redundant or literals were removed from 'c'. */
+static int
+run_task (QRATPrePlus * qr, Scheduler *s, Clause *c, QRATPlusTechnique t)
+{
+  switch (t)
+    {
+    case QRATPLUS_TECHNIQUE_QBCE:
+      return is_clause_blocked (qr, c);
+    case QRATPLUS_TECHNIQUE_AT:
+      return qrat_qat_check (qr, c);
+    case QRATPLUS_TECHNIQUE_QRATE:
+      return has_clause_qrat (qr, c);
+    case QRATPLUS_TECHNIQUE_BLE:
+      return has_clause_blocked_literals (qr, c, &s->changed_vars);
+    case QRATPLUS_TECHNIQUE_QRATU:
+      return has_clause_qrat_literals (qr, c, &s->changed_vars);
+    default:
+      assert (0);
+      return 0;
+    }
+}
+
+/* Index of the live occurrence counter of literal 'lit' in pure literal
+   elimination. */
+#define PURE_CNT_INDEX(lit) (2 * LIT2VARID (lit) + LIT_NEG (lit))
+
+/* Decrement the live occurrence counter of 'lit' and collect its variable
+   as a candidate if the counter reaches zero. */
+static void
+dec_live_occ_cnt (QRATPrePlus * qr, unsigned int *cnts, LitID lit,
+                  VarPtrStack *candidates)
+{
+  unsigned int *cnt = cnts + PURE_CNT_INDEX (lit);
+  assert (*cnt > 0);
+  if (--(*cnt) == 0)
+    PUSH_STACK (qr->mm, *candidates, LIT2VARPTR (qr->pcnf.vars, lit));
+}
+
+/* Eliminate pure literal 'lit': clauses containing an existential pure
+   literal are blocked since they have no resolution partners, and a
+   universal pure literal is blocked in every clause. Universal pure
+   literals are kept unless 'universal' is nonzero. */
+static void
+eliminate_pure_literal (QRATPrePlus * qr, LitID lit, unsigned int *cnts,
+                        VarPtrStack *candidates, VarPtrStack *changed_vars,
+                        int universal)
+{
+  Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
+  if (var->qblock->type == QTYPE_FORALL && !universal)
+    return;
+  ClausePtrStack *occs = LIT_NEG (lit) ?
+    &var->neg_occ_clauses : &var->pos_occ_clauses;
+  Clause **cp, **ce;
+  for (cp = occs->start, ce = occs->top; cp < ce; cp++)
+    {
+      Clause *c = *cp;
+      if (c->redundant || is_stale_occ (qr, c, lit) ||
+          (qr->options.ignore_outermost_vars &&
+           clause_has_outermost_qblock_literal (qr, c)))
+        continue;
+      if (var->qblock->type == QTYPE_EXISTS)
+        {
+          mark_clause_redundant (qr, c);
+          qr->cnt_redundant_clauses++;
+          qr->cnt_pure_lit_clauses++;
+          LitID *p, *e;
+          for (p = c->lits, e = p + c->num_lits; p < e; p++)
+            dec_live_occ_cnt (qr, cnts, *p, candidates);
+        }
+      else
+        {
+          if (QRATPREPLUS_TRACE (qr))
+            {
+              fprintf (stderr, "  ==> universal literal %d is pure in clause ", lit);
+              print_lits (qr, stderr, c->lits, c->num_lits, 1);
+            }
+          cleanup_redundant_universal_literal (qr, c, lit);
+          dec_live_occ_cnt (qr, cnts, lit, candidates);
+          collect_changed_var (qr, changed_vars, lit);
+          collect_changed_vars_of_clause (qr, changed_vars, c);
+          qr->cnt_redundant_literals++;
+          qr->cnt_pure_lit_univ_lits++;
+        }
+    }
+}
+
 /* -------------------- START: PUBLIC FUNCTIONS -------------------- */
 
 void
 unlink_redundant_clauses (QRATPrePlus * qr)
 {
-  qr->max_clause_length = 0;
-  qr->total_clause_lengths = 0;
+  /* Unlink only the clauses found redundant since the last call and
+     collect their variables, whose occurrences must be updated. */
+  Clause **cp, **ce;
+  for (cp = qr->redundant_clauses.start + qr->cnt_unlinked_redundant_clauses,
+         ce = qr->redundant_clauses.top; cp < ce; cp++)
+    {
+      Clause *c = *cp;
+      assert (c->redundant);
+      UNLINK (qr->pcnf.clauses, c, link);
+      qr->total_clause_lengths -= c->num_lits;
+      /* Watched occurrences are not updated here but purged lazily. */
+      if (c->lw_index != WATCHED_LIT_INVALID_INDEX)
+        {
+          LIT2VARPTR (qr->pcnf.vars, c->lits[c->lw_index])->cnt_redundant_watched++;
+          LIT2VARPTR (qr->pcnf.vars, c->lits[c->rw_index])->cnt_redundant_watched++;
+        }
+      LitID *p, *e;
+      for (p = c->lits, e = p + c->num_lits; p < e; p++)
+        collect_dirty_var (qr, LIT2VARPTR (qr->pcnf.vars, *p));
+    }
+  qr->cnt_unlinked_redundant_clauses = COUNT_STACK (qr->redundant_clauses);
 
-  Clause *c, *n;
-  for (c = qr->pcnf.clauses.first; c; c = n)
+  Var **vp, **ve;
+  for (vp = qr->dirty_vars.start, ve = qr->dirty_vars.top; vp < ve; vp++)
     {
-      n = c->link.next;
-      if (c->redundant)
-        UNLINK (qr->pcnf.clauses, c, link);
-      else
+      Var *var = *vp;
+      var->dirty = 0;
+      unsigned int old_neg_cnt = count_occs (var, &var->neg_occ_clauses);
+      unsigned int old_pos_cnt = count_occs (var, &var->pos_occ_clauses);
+      unlink_redundant_clauses_occs (qr, &var->neg_occ_clauses, -(LitID) var->id);
+      unlink_redundant_clauses_occs (qr, &var->pos_occ_clauses, var->id);
+      assert (COUNT_STACK (var->neg_occ_clauses) <= old_neg_cnt);
+      assert (COUNT_STACK (var->pos_occ_clauses) <= old_pos_cnt);
+      var->cnt_stale_neg_occs = var->cnt_stale_pos_occs = 0;
+      update_occ_limit_marks (qr, var, &var->neg_occ_clauses, old_neg_cnt);
+      update_occ_limit_marks (qr, var, &var->pos_occ_clauses, old_pos_cnt);
+
+      /* Update statistics. */
+      qr->total_occ_cnts -= old_neg_cnt - COUNT_STACK (var->neg_occ_clauses);
+      qr->total_occ_cnts -= old_pos_cnt - COUNT_STACK (var->pos_occ_clauses);
+    }
+  RESET_STACK (qr->dirty_vars);
+}
+
+/* Returns nonzero if some other clause subsumes 'c'. */
+static int
+is_subsumed_by_occ (QRATPrePlus * qr, Clause * c)
+{
+  /* A clause 'd' subsuming 'c' contains only literals of 'c'. Check 'd'
+     only when visiting the occurrences of its first literal so that every
+     clause is checked at most once. */
+  LitID *p, *e;
+  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+    {
+      Var *var = LIT2VARPTR (qr->pcnf.vars, *p);
+      ClausePtrStack *occs = LIT_NEG (*p) ?
+        &var->neg_occ_clauses : &var->pos_occ_clauses;
+      Clause **cp, **ce;
+      for (cp = occs->start, ce = occs->top; cp < ce; cp++)
         {
-          qr->total_clause_lengths += c->num_lits;
-          if (c->num_lits > qr->max_clause_length)
-            qr->max_clause_length = c->num_lits;
+          Clause *d = *cp;
+          if (d == c || d->redundant || d->lits[0] != *p ||
+              is_stale_occ (qr, d, *p))
+            continue;
+          if (d->sig & ~c->sig)
+            {
+              qr->clause_redundancy_or_checks_sig_filtered++;
+              continue;
+            }
+          if (is_clause_subset (d, c))
+            return 1;
         }
     }
+  return 0;
+}
+
+void
+subsume_imported_clause (QRATPrePlus * qr, Clause * c)
+{
+  if (c->num_lits == 0)
+    return;
+
+  if ((!qr->options.ignore_outermost_vars ||
+       !clause_has_outermost_qblock_literal (qr, c)) &&
+      is_subsumed_by_occ (qr, c))
+    {
+      mark_clause_subsumed (qr, c);
+      return;
+    }
 
-  qr->max_occ_cnt = 0;
-  qr->total_occ_cnts = 0;
+  mark_clauses_subsumed_by (qr, c);
+}
+
+int
+find_and_mark_subsumed_clauses (QRATPrePlus * qr)
+{
+  double start = time_stamp ();
+  unsigned int cnt_before = qr->cnt_subsumed_clauses;
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    if (!c->redundant && c->num_lits > 0)
+      mark_clauses_subsumed_by (qr, c);
+
+  if (qr->options.verbosity >= 1)
+    fprintf (stderr, "Subsumption: %u subsumed clauses in %f sec\n",
+             qr->cnt_subsumed_clauses - cnt_before, time_stamp () - start);
+  return qr->cnt_subsumed_clauses > cnt_before;
+}
+
+int
+eliminate_pure_literals (QRATPrePlus * qr, int universal)
+{
+  double start = time_stamp ();
+  unsigned int clauses_before = qr->cnt_pure_lit_clauses;
+  unsigned int lits_before = qr->cnt_pure_lit_univ_lits;
+
+  /* As in literal elimination, witnesses of the previous clause
+     elimination phases are not needed for rescheduling anymore. */
+  reset_witness_clauses (qr);
+
+  /* Occurrence counts are exact without redundant clauses and stale
+     entries. */
+  unlink_redundant_clauses (qr);
+
+  const size_t bytes = 2 * qr->pcnf.size_vars * sizeof (unsigned int);
+  unsigned int *cnts = mm_malloc (qr->mm, bytes);
+  VarPtrStack candidates;
+  INIT_STACK (candidates);
+  VarPtrStack changed_vars;
+  INIT_STACK (changed_vars);
 
   Var *var, *vars_end;
-  for (var = qr->pcnf.vars, vars_end = var + qr->pcnf.size_vars; 
+  for (var = qr->pcnf.vars, vars_end = var + qr->pcnf.size_vars;
        var < vars_end; var++)
     {
-      unlink_redundant_clauses_occs (qr, &var->neg_occ_clauses);
-      unlink_redundant_clauses_occs (qr, &var->pos_occ_clauses);
-      
-      unlink_redundant_clauses_occs (qr, &var->watched_neg_occ_clauses);
-      unlink_redundant_clauses_occs (qr, &var->watched_pos_occ_clauses);
+      VarID id = var - qr->pcnf.vars;
+      cnts[PURE_CNT_INDEX ((LitID) id)] = COUNT_STACK (var->pos_occ_clauses);
+      cnts[PURE_CNT_INDEX (-(LitID) id)] = COUNT_STACK (var->neg_occ_clauses);
+      if (EMPTY_STACK (var->pos_occ_clauses) != EMPTY_STACK (var->neg_occ_clauses))
+        PUSH_STACK (qr->mm, candidates, var);
+    }
 
-      /* Update statistics. */
-      qr->total_occ_cnts += COUNT_STACK (var->neg_occ_clauses);
-      qr->total_occ_cnts += COUNT_STACK (var->pos_occ_clauses);
-      if ((unsigned int) COUNT_STACK (var->neg_occ_clauses) > qr->max_occ_cnt)
-        qr->max_occ_cnt = (unsigned int) COUNT_STACK (var->neg_occ_clauses);
-      if ((unsigned int) COUNT_STACK (var->pos_occ_clauses) > qr->max_occ_cnt)
-        qr->max_occ_cnt = (unsigned int) COUNT_STACK (var->pos_occ_clauses);
+  /* Eliminating a pure literal decrements the counters of other literals,
+     which become candidates when their counters reach zero. */
+  while (!EMPTY_STACK (candidates))
+    {
+      var = POP_STACK (candidates);
+      VarID id = var - qr->pcnf.vars;
+      unsigned int pos_cnt = cnts[PURE_CNT_INDEX ((LitID) id)];
+      unsigned int neg_cnt = cnts[PURE_CNT_INDEX (-(LitID) id)];
+      if (pos_cnt && !neg_cnt)
+        eliminate_pure_literal (qr, (LitID) id, cnts, &candidates,
+                                &changed_vars, universal);
+      else if (!pos_cnt && neg_cnt)
+        eliminate_pure_literal (qr, -(LitID) id, cnts, &candidates,
+                                &changed_vars, universal);
     }
+
+  /* Clauses from which literals were removed must be rescheduled in the
+     next global iteration. */
+  collect_touched_vars (qr, &changed_vars);
+  Var **vp, **ve;
+  for (vp = changed_vars.start, ve = changed_vars.top; vp < ve; vp++)
+    VAR_UNMARK (*vp);
+
+  DELETE_STACK (qr->mm, changed_vars);
+  DELETE_STACK (qr->mm, candidates);
+  mm_free (qr->mm, cnts, bytes);
+
+  if (qr->options.verbosity >= 1)
+    fprintf (stderr, "Pure literals: %u clauses, %u universal literals "
+             "eliminated in %f sec\n", qr->cnt_pure_lit_clauses - clauses_before,
+             qr->cnt_pure_lit_univ_lits - lits_before, time_stamp () - start);
+  return qr->cnt_pure_lit_clauses > clauses_before ||
+    qr->cnt_pure_lit_univ_lits > lits_before;
 }
 
 /* Top-level function of literal redundancy detection. Returns nonzero iff
@@ -1142,8 +3206,10 @@ find_and_delete_redundant_literals (QRATPrePlus * qr)
           /* Schedule all input clauses to be checked. */
           reschedule_from_input_clauses (qr, &rescheduled);
         }
+      double start = wall_time_stamp ();
       result = find_and_delete_redundant_literals_aux 
         (qr, &to_be_checked, &rescheduled, QRATPLUS_CHECK_MODE_QRAT) || result;
+      qr->qratu_wall_time += wall_time_stamp () - start;
     }
   
   DELETE_STACK (qr->mm, to_be_checked);
@@ -1151,6 +3217,212 @@ find_and_delete_redundant_literals (QRATPrePlus * qr)
   return result;
 }
 
+/* Schedule clauses to be checked in a phase of clause elimination. In the
+   first global iteration, all clauses are scheduled. Later global
+   iterations are triggered by removing redundant literals. The result of a
+   QBCE check of a clause depends only on its resolution partners, hence it
+   may change only if the clause shares a variable with a clause from which
+   literals were removed (i.e., a variable on 'qr->touched_vars') or if one
+   of its resolution partners was found redundant since QBCE was last run
+   (i.e., after 'seen_redundant' clauses on 'qr->redundant_clauses'). In
+   QBCE, only these clauses are scheduled. Since the results of AT and QRAT
+   checks depend on QBCP in the entire formula, this is only an
+   approximation in AT and QRATE, which is applied if option
+   'incremental_global_iterations' is set. Clause eliminations do not make
+   AT checks succeed since QBCP gets weaker, hence 'seen_redundant' is null
+   in AT. */
+static void
+reschedule_for_global_iteration (QRATPrePlus * qr, ClausePtrStack *rescheduled,
+                                 const QRATPlusCheckMode mode,
+                                 unsigned int *seen_redundant)
+{
+  if (qr->cnt_global_iterations <= 1 ||
+      (mode != QRATPLUS_CHECK_MODE_QBCE &&
+       !qr->options.incremental_global_iterations))
+    {
+      reschedule_from_input_clauses (qr, rescheduled);
+      return;
+    }
+
+  Var **vp, **ve;
+  for (vp = qr->touched_vars.start, ve = qr->touched_vars.top; vp < ve; vp++)
+    {
+      Var *var = *vp;
+      unsigned int neg;
+      for (neg = 0; neg <= 1; neg++)
+        {
+          ClausePtrStack *occs = neg ?
+            &var->neg_occ_clauses : &var->pos_occ_clauses;
+          Clause *oc, **cp, **ce;
+          for (cp = occs->start, ce = occs->top; cp < ce; cp++)
+            {
+              oc = *cp;
+              if (!oc->redundant && !oc->rescheduled &&
+                  reschedule_is_clause_within_limits (qr, oc))
+                {
+                  oc->rescheduled = 1;
+                  PUSH_STACK (qr->mm, *rescheduled, oc);
+                }
+            }
+        }
+    }
+
+  if (seen_redundant)
+    {
+      Clause **cp, **ce;
+      for (cp = qr->redundant_clauses.start + *seen_redundant,
+             ce = qr->redundant_clauses.top; cp < ce; cp++)
+        reschedule_from_redundant_clause (qr, *cp, rescheduled);
+    }
+
+  /* Clauses to be checked are expected to be sorted by ID as in the list of
+     clauses. */
+  RESET_STACK (*rescheduled);
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    if (c->rescheduled)
+      PUSH_STACK (qr->mm, *rescheduled, c);
+
+  if (qr->options.verbosity >= 1)
+    fprintf (stderr, "Global iteration %u: scheduled %u clauses affected by %u touched variables\n",
+             qr->cnt_global_iterations, (unsigned int) COUNT_STACK (*rescheduled),
+             (unsigned int) COUNT_STACK (qr->touched_vars));
+}
+
+/* Top-level function of the priority schedule. All enabled techniques are
+   scheduled for all clauses initially. Tasks are checked in the order of
+   their priorities, and the clauses that may be affected by a successful
+   check are scheduled again right away. Returns nonzero iff redundant
+   clauses or literals were found. */
+int
+find_and_remove_redundancies_by_priority (QRATPrePlus * qr)
+{
+  int result = 0;
+  Scheduler s;
+  memset (&s, 0, sizeof (s));
+  s.queued = mm_malloc (qr->mm, (qr->cur_clause_id + 1) * sizeof (unsigned char));
+  if (!qr->options.no_qbce)
+    s.enabled |= QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QBCE);
+  if (!qr->options.no_qat)
+    s.enabled |= QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_AT);
+  if (!qr->options.no_qrate)
+    s.enabled |= QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QRATE);
+  if (!qr->options.no_ble)
+    s.enabled |= QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_BLE);
+  if (!qr->options.no_qratu)
+    s.enabled |= QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QRATU);
+
+  /* Redundant clauses are unlinked from the data structures whenever their
+     number has grown by a sixteenth of the clauses. */
+  unlink_redundant_clauses (qr);
+  unsigned int unlinked = COUNT_STACK (qr->redundant_clauses);
+
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    schedule_clause (qr, &s, c, QRATPLUS_ALL_TECHNIQUES);
+
+  long long unsigned int cnt_tasks = 0;
+  int exceeded = 0;
+  unsigned int t;
+  while (!exceeded)
+    {
+      if ((t = select_technique (&s)) == QRATPLUS_NUM_TECHNIQUES)
+        {
+          /* As in the phases, literals removed since the last global
+             iteration may have made AT or QRAT checks of any clause
+             succeed. */
+          if (!s.full_reschedule ||
+              qr->cnt_global_iterations >= qr->limit_global_iterations)
+            break;
+          qr->cnt_global_iterations++;
+          if (qr->options.verbosity >= 1)
+            fprintf (stderr, "Priority schedule: global iteration %u after %llu checks\n",
+                     qr->cnt_global_iterations, cnt_tasks);
+          for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+            schedule_clause (qr, &s, c, s.full_reschedule);
+          s.full_reschedule = 0;
+          continue;
+        }
+
+      Task task = pop_task (s.heaps + t);
+      c = task.clause;
+      s.queued[c->id] &= ~QRATPLUS_TECHNIQUE_BIT (t);
+      if (c->redundant)
+        continue;
+
+      cnt_tasks++;
+      if ((cnt_tasks & ((1 << QRATPLUS_SOFT_TIME_LIMIT_CHECK_PERIOD) - 1)) == 0 &&
+          (exceeded = exceeded_soft_time_limit (qr)))
+        {
+          fprintf (stderr, "Exceeded soft time limit of %u sec after %llu scheduled checks\n",
+                   qr->soft_time_limit, cnt_tasks);
+          break;
+        }
+
+      if (QRATPREPLUS_TRACE (qr))
+        {
+          fprintf (stderr, "\n%s check on clause ", technique_names[t]);
+          print_lits (qr, stderr, c->lits, c->num_lits, 1);
+        }
+
+      const int clause_technique =
+        (QRATPLUS_TECHNIQUE_BIT (t) & QRATPLUS_CLAUSE_TECHNIQUES) != 0;
+      if (clause_technique)
+        qr->cnt_qbce_checks++;
+      else
+        qr->cnt_qratu_checks++;
+
+      unsigned int num_lits_before = c->num_lits;
+      s.attempts[t]++;
+      if (!run_task (qr, &s, c, task.technique))
+        continue;
+      s.successes[t]++;
+      result = 1;
+
+      if (clause_technique)
+        {
+          mark_clause_redundant (qr, c);
+          qr->cnt_redundant_clauses++;
+          schedule_from_redundant_clause (qr, &s, c);
+        }
+      else
+        {
+          assert (num_lits_before > c->num_lits);
+          qr->cnt_redundant_literals += num_lits_before - c->num_lits;
+          collect_changed_vars_of_clause (qr, &s.changed_vars, c);
+          schedule_from_changed_vars (qr, &s);
+          if (!qr->options.incremental_global_iterations)
+            s.full_reschedule |=
+              QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_AT) |
+              QRATPLUS_TECHNIQUE_BIT (QRATPLUS_TECHNIQUE_QRATE);
+        }
+
+      if (COUNT_STACK (qr->redundant_clauses) - unlinked >
+          qr->pcnf.clauses.cnt / 16)
+        {
+          unlink_redundant_clauses (qr);
+          unlinked = COUNT_STACK (qr->redundant_clauses);
+        }
+    }
+
+  if (qr->options.verbosity >= 1)
+    {
+      fprintf (stderr, "\nPriority schedule: %llu checks\n", cnt_tasks);
+      for (t = 0; t < QRATPLUS_NUM_TECHNIQUES; t++)
+        if (s.enabled & QRATPLUS_TECHNIQUE_BIT (t))
+          fprintf (stderr, "  %s: %llu successful of %llu checks\n",
+                   technique_names[t], s.successes[t], s.attempts[t]);
+    }
+
+  assert (EMPTY_STACK (s.changed_vars));
+  reset_witness_clauses (qr);
+  DELETE_STACK (qr->mm, s.changed_vars);
+  for (t = 0; t < QRATPLUS_NUM_TECHNIQUES; t++)
+    DELETE_STACK (qr->mm, s.heaps[t]);
+  mm_free (qr->mm, s.queued, (qr->cur_clause_id + 1) * sizeof (unsigned char));
+  return result;
+}
+
 /* Top-level function of clause redundancy detection. Returns nonzero iff
    redundant clauses were found. */
 int
@@ -1171,10 +3443,13 @@ find_and_mark_redundant_clauses (QRATPrePlus * qr)
     {
       /* Initially, schedule all input clauses to be checked. */
       assert (EMPTY_STACK (rescheduled));
-      reschedule_from_input_clauses (qr, &rescheduled);
+      reschedule_for_global_iteration (qr, &rescheduled,
+                                       QRATPLUS_CHECK_MODE_QBCE,
+                                       &qr->qbce_seen_redundant);
       result = find_and_mark_redundant_clauses_aux (qr, &to_be_checked, 
                                                     &rescheduled, 
                                                     QRATPLUS_CHECK_MODE_QBCE) || result;
+      qr->qbce_seen_redundant = COUNT_STACK (qr->redundant_clauses);
     }
   
   /* AT checking. */
@@ -1189,7 +3464,8 @@ find_and_mark_redundant_clauses (QRATPrePlus * qr)
       /* After QBCE, schedule all input clauses that have not been found redundant
          (i.e., blocked) already to be checked for AT. */
       assert (EMPTY_STACK (rescheduled));
-      reschedule_from_input_clauses (qr, &rescheduled);
+      reschedule_for_global_iteration (qr, &rescheduled,
+                                       QRATPLUS_CHECK_MODE_AT, 0);
 
       /* Remove redundant clauses from data structures, which should improve
          QBCP performance. */
@@ -1213,7 +3489,9 @@ find_and_mark_redundant_clauses (QRATPrePlus * qr)
       /* After QBCE, schedule all input clauses that have not been found redundant
          (i.e., blocked) already to be checked for QRAT. */
       assert (EMPTY_STACK (rescheduled));
-      reschedule_from_input_clauses (qr, &rescheduled);
+      reschedule_for_global_iteration (qr, &rescheduled,
+                                       QRATPLUS_CHECK_MODE_QRAT,
+                                       &qr->qrate_seen_redundant);
 
       /* Remove redundant clauses from data structures, which should improve
          QBCP performance. */ 
@@ -1227,11 +3505,29 @@ find_and_mark_redundant_clauses (QRATPrePlus * qr)
       result = find_and_mark_redundant_clauses_aux (qr, &to_be_checked,
                                                     &rescheduled, 
                                                     QRATPLUS_CHECK_MODE_QRAT) || result;
+      qr->qrate_seen_redundant = COUNT_STACK (qr->redundant_clauses);
     }
 
+  /* All phases have been scheduled with respect to the touched variables. */
+  Var **vp, **ve;
+  for (vp = qr->touched_vars.start, ve = qr->touched_vars.top; vp < ve; vp++)
+    (*vp)->touched = 0;
+  RESET_STACK (qr->touched_vars);
+
   DELETE_STACK (qr->mm, to_be_checked);
   DELETE_STACK (qr->mm, rescheduled);
   return result;
 }
 
+void
+select_outer_tautology_kernel (QRATPrePlus * qr)
+{
+  if (qr->propositional)
+    qr->outer_tautology_kernel = check_outer_tautology_propositional;
+  else if (qr->options.qbce_check_taut_by_nesting)
+    qr->outer_tautology_kernel = check_outer_tautology_by_nesting;
+  else
+    qr->outer_tautology_kernel = check_outer_tautology_all_lits;
+}
+
 /* -------------------- END: PUBLIC FUNCTIONS -------------------- */
@@ -25,6 +25,7 @@
 #define QRATPREPLUS_QBCE_H_INCLUDED
 
 #include "qratpreplus.h"
+#include "qratpreplus_internals.h"
 
 /* Returns nonzero iff redundant clauses were found. */
 int find_and_mark_redundant_clauses (QRATPrePlus * qr);
@@ -34,5 +35,39 @@ int find_and_delete_redundant_literals (QRATPrePlus * qr);
 
 void unlink_redundant_clauses (QRATPrePlus * qr);
 
+/* Sort occurrence stacks according to option 'occ_order'. */
+void order_occurrences (QRATPrePlus * qr);
+
+/* Mark all clauses where the complementary occurrences of some literal
+   exceed the occurrence limit. Must be called before redundancy checking if
+   the limit is set. */
+void mark_clauses_exceeding_occ_limit (QRATPrePlus * qr);
+
+/* Subsumption of clause 'c' which was just imported: mark 'c' as
+   redundant if it is subsumed by a clause imported earlier, otherwise mark
+   the clauses imported earlier that are subsumed by 'c'. */
+void subsume_imported_clause (QRATPrePlus * qr, Clause * c);
+
+/* Mark all clauses that are subsumed by other clauses as redundant, e.g.,
+   after literals were removed. Returns nonzero iff subsumed clauses were
+   found. */
+int find_and_mark_subsumed_clauses (QRATPrePlus * qr);
+
+/* Eliminate pure literals by live occurrence counters: clauses containing
+   an existential pure literal are marked redundant and, if 'universal' is
+   nonzero, universal pure literals are removed, until no pure literals are
+   left. Returns nonzero iff pure literals were found. */
+int eliminate_pure_literals (QRATPrePlus * qr, int universal);
+
+/* Select the variant of the outer tautology check of QBCE and BLE,
+   depending on 'qr->propositional' and option
+   'qbce_check_taut_by_nesting'. */
+void select_outer_tautology_kernel (QRATPrePlus * qr);
+
+/* Apply all enabled techniques interleaved by priority until
+   saturation. Returns nonzero iff redundant clauses or literals were
+   found. */
+int find_and_remove_redundancies_by_priority (QRATPrePlus * qr);
+
 
 #endif
@@ -23,6 +23,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 #include "qbcp.h"
 #include "util.h"
 
@@ -37,6 +38,15 @@
 #define ASSERT_WATCHED_LIT_STATE_BEFORE_ASSIGNING 0
 #endif
 
+/* Watched occurrences of a variable are purged from redundant clauses if
+   at least one out of 'QRATPLUS_WATCHED_PURGE_RATIO' is redundant. */
+#define QRATPLUS_WATCHED_PURGE_RATIO 4
+
+/* Initial number of slots of the propagation cache (power of two) and
+   maximum number of cached literals, beyond which the cache is cleared. */
+#define QRATPLUS_PROP_CACHE_INIT_SIZE 1024
+#define QRATPLUS_PROP_CACHE_MAX_LITS (1 << 24)
+
 /* ---------- START: QUANTIFIER TYPE ABSTRACTION ---------- */
 
 /* A qblock 's' is existential if it is existential in the prefix of
@@ -89,14 +99,17 @@ eabs_is_lit_existential (QRATPrePlus * qr, LitID lit)
 
 /* ---------- END: QUANTIFIER TYPE ABSTRACTION ---------- */
 
+/* Parameter 'trace' enables trace output. It is constant in the QBCP
+   kernels, see 'select_qbcp_kernel'. */
 static void
-assign_and_enqueue (QRATPrePlus * qr, Var * var, Assignment a)
+assign_and_enqueue (QRATPrePlus * qr, Var * var, Assignment a,
+                    const int trace)
 {
   assert (a != ASSIGNMENT_UNDEF);
   assert (var->assignment == ASSIGNMENT_UNDEF);
   var->assignment = a;
   PUSH_STACK (qr->mm, qr->qbcp_queue, var->id);
-  if (qr->options.verbosity >= 2)
+  if (trace)
     {
       fprintf (stderr, "  enqueued assignment: %d\n",
                var->assignment == ASSIGNMENT_FALSE ? -var->id : var->id);
@@ -137,7 +150,7 @@ retract_re_init_lit_watchers (QRATPrePlus * qr)
       assert (c->num_lits >= 2);
       if (!c->ignore_in_qbcp && !c->redundant)
         {
-          if (qr->options.verbosity >= 2)
+          if (QRATPREPLUS_TRACE (qr))
             {
               fprintf (stderr, "  retract watchers of clause ID %u: ", c->id);
               print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -173,13 +186,13 @@ retract_re_init_lit_watchers (QRATPrePlus * qr)
 
               assert (c->lw_index < c->rw_index);
 
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 fprintf (stderr, "    ...updated to: lw-index %u and rw-index %u\n", 
                          c->lw_index, c->rw_index);
             }
           else
             {
-              if (qr->options.verbosity >= 2)
+              if (QRATPREPLUS_TRACE (qr))
                 fprintf (stderr, "    ...not updated, rw-index %u existential\n", 
                          c->rw_index);
             }
@@ -212,11 +225,6 @@ retract (QRATPrePlus * qr)
       retract_assigned_var (qr, prop_var);
     }
   RESET_STACK (qr->qbcp_queue);
-
-  /* When using abstraction, must make sure that right watcher is always
-     at an existential literal. Update watchers in collected clauses. */
-  if (!qr->options.no_eabs)
-    retract_re_init_lit_watchers (qr);
 }
 
 /* Find index of a new unassigned literal in 'c->lits' to watch, starting to
@@ -224,11 +232,13 @@ retract (QRATPrePlus * qr)
    desired quantifier type. If 'desired_type == QTYPE_UNDEF' then ignore
    quantifier type of literal. Returns 'WATCHED_LIT_INVALID_INDEX' if no such
    literal is found, or 'WATCHED_LIT_CLAUSE_SAT' if clause satisfied, or index
-   of new watched literal. */
-static unsigned int
+   of new watched literal. If 'no_eabs' then all variables are treated as
+   existential. */
+static QRATPREPLUS_KERNEL_INLINE unsigned int
 get_index_of_new_watched_lit (QRATPrePlus * qr, Clause *c, 
                               unsigned int start_index, 
-                              QuantifierType desired_type)
+                              QuantifierType desired_type,
+                              const int no_eabs)
 {
   /* We never explicitly look for universal literals to watch. */
   assert (desired_type == QTYPE_UNDEF || desired_type == QTYPE_EXISTS);
@@ -240,7 +250,8 @@ get_index_of_new_watched_lit (QRATPrePlus * qr, Clause *c,
       Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
       if (var->assignment == ASSIGNMENT_UNDEF)
         {
-          if (desired_type == QTYPE_UNDEF || eabs_is_var_existential (qr, var))
+          if (desired_type == QTYPE_UNDEF || no_eabs ||
+              eabs_is_var_existential (qr, var))
             return (p - e);
         }
       else
@@ -327,12 +338,11 @@ check_smaller_universal_lits_falsified (QRATPrePlus *qr, Clause *c,
   Var *check_var = LIT2VARPTR (qr->pcnf.vars, check_lit);
   assert (eabs_is_var_existential (qr, check_var));
   LitID *p, *e;
-  for (p = c->lits, e = p + c->num_lits; p < e; p++)
+  for (p = c->lits, e = p + get_nesting_cutoff (c, check_var->qblock->nesting);
+       p < e; p++)
     {
       LitID lit = *p;
       Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
-      if (var->qblock->nesting > check_var->qblock->nesting)
-        return 1;
       assert (var->qblock->nesting <= check_var->qblock->nesting);
       /* Check assignment of universal literals smaller than 'check_lit'. */
       if (eabs_get_qtype_of_var (qr, var) == QTYPE_FORALL)
@@ -365,28 +375,46 @@ is_clause_unit (QRATPrePlus *qr, Clause *c)
     return 1;
 }
 
+/* When computing an entry of the propagation cache, check whether clause
+   'c', which is unit or conflicting, contains the pivot of the entry. */
+static void
+check_prop_cache_taint (QRATPrePlus * qr, Clause *c)
+{
+  if (qr->prop_cache_pivot && !qr->prop_cache_tainted &&
+      find_literal (qr->prop_cache_pivot, c->lits, c->lits + c->num_lits))
+    qr->prop_cache_tainted = 1;
+}
+
 static void
-handle_unit_clause (QRATPrePlus * qr, Clause *c, LitID unit_lit)
+handle_unit_clause (QRATPrePlus * qr, Clause *c, LitID unit_lit,
+                    const int trace)
 {
   assert (is_clause_unit (qr, c));
+  check_prop_cache_taint (qr, c);
   LitID unassigned_lit = unit_lit;
-  if (qr->options.verbosity >= 2)
+  if (trace)
     fprintf (stderr, "    clause has unit literal %d\n", unassigned_lit);
   Var *unassigned_var = LIT2VARPTR (qr->pcnf.vars, unassigned_lit);
   assign_and_enqueue (qr, unassigned_var, LIT_NEG (unassigned_lit) ?
-                      ASSIGNMENT_FALSE : ASSIGNMENT_TRUE);
+                      ASSIGNMENT_FALSE : ASSIGNMENT_TRUE, trace);
 }
 
 /* Like 'propagate_clause (...)' but check and updated watched literals to see
-   if clause is satisfied, unit, or conflicting under enqueued assignment. */
-static QBCPState
-propagate_clause_watched_lits (QRATPrePlus * qr, Clause *c)
+   if clause is satisfied, unit, or conflicting under enqueued assignment.
+   Parameters 'no_eabs' and 'trace' stand for option '--no-eabs' and trace
+   output and are constant in the QBCP kernels. */
+static QRATPREPLUS_KERNEL_INLINE QBCPState
+propagate_clause_watched_lits (QRATPrePlus * qr, Clause *c,
+                               const int no_eabs, const int trace)
 {
   assert (!c->ignore_in_qbcp);
   assert (!c->redundant);
   assert (c->num_lits >= 2);
 
-  if (qr->options.verbosity >= 2)
+  if (qr->is_worker)
+    record_used_clause (qr, c);
+
+  if (trace)
     {
       fprintf (stderr, "  propagate clause ID %u and updating watched literals: ", c->id);
       print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -423,7 +451,8 @@ propagate_clause_watched_lits (QRATPrePlus * qr, Clause *c)
 
   /* For simplicity, always update both watched literals. */
   unsigned int new_rw_index = 
-    get_index_of_new_watched_lit (qr, c, c->num_lits - 1, QTYPE_EXISTS);
+    get_index_of_new_watched_lit (qr, c, c->num_lits - 1, QTYPE_EXISTS,
+                                  no_eabs);
 
   /* Return immediately if clause found satisfied. */
   if (new_rw_index == WATCHED_LIT_CLAUSE_SAT)
@@ -435,6 +464,7 @@ propagate_clause_watched_lits (QRATPrePlus * qr, Clause *c)
   else if (new_rw_index == WATCHED_LIT_INVALID_INDEX)
     {
       assert (is_clause_empty (qr, c));
+      check_prop_cache_taint (qr, c);
       return QBCP_STATE_UNSAT;
     }
 
@@ -444,14 +474,15 @@ propagate_clause_watched_lits (QRATPrePlus * qr, Clause *c)
   /* Handle unit clause. */
   if (new_rw_index == 0)
     {
-      handle_unit_clause (qr, c, c->lits[new_rw_index]);
+      handle_unit_clause (qr, c, c->lits[new_rw_index], trace);
       return QBCP_STATE_UNKNOWN;
     }
 
   /* Search for index of new left watcher starting one position to the left of
      new right watcher. */
   unsigned int new_lw_index = 
-    get_index_of_new_watched_lit (qr, c, new_rw_index - 1, QTYPE_UNDEF);
+    get_index_of_new_watched_lit (qr, c, new_rw_index - 1, QTYPE_UNDEF,
+                                  no_eabs);
 
   if (new_lw_index == WATCHED_LIT_CLAUSE_SAT)
     {
@@ -461,7 +492,7 @@ propagate_clause_watched_lits (QRATPrePlus * qr, Clause *c)
   /* No new left watcher: clause is unit. */
   else if (new_lw_index == WATCHED_LIT_INVALID_INDEX)
     {
-      handle_unit_clause (qr, c, c->lits[new_rw_index]);
+      handle_unit_clause (qr, c, c->lits[new_rw_index], trace);
       return QBCP_STATE_UNKNOWN;
     }
 
@@ -492,12 +523,12 @@ propagate_clause_watched_lits (QRATPrePlus * qr, Clause *c)
          currently treated as existential under the abstraction. When retracting
          assignments, must make sure to properly set right watcher to an
          existential literal. */
-      if (!qr->options.no_eabs && new_rw_var->qblock->type == QTYPE_FORALL && 
+      if (!no_eabs && new_rw_var->qblock->type == QTYPE_FORALL && 
           !c->lw_update_collected)
         {
           c->lw_update_collected = 1;
           PUSH_STACK (qr->mm, qr->lw_update_clauses, c);
-          if (qr->options.verbosity >= 2)
+          if (trace)
             {
               fprintf (stderr, "    collected clause ID %u for eabs right watcher update: ", c->id);
               print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -535,7 +566,10 @@ propagate_clause (QRATPrePlus * qr, Clause *c)
   assert (!c->ignore_in_qbcp);
   assert (!c->redundant);
 
-  if (qr->options.verbosity >= 2)
+  if (qr->is_worker)
+    record_used_clause (qr, c);
+
+  if (QRATPREPLUS_TRACE (qr))
     {
       fprintf (stderr, "  propagate clause: ");
       print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -553,7 +587,7 @@ propagate_clause (QRATPrePlus * qr, Clause *c)
         {
           cnt_unassigned++;
           unassigned_lit = lit;
-          if (qr->options.verbosity >= 2)
+          if (QRATPREPLUS_TRACE (qr))
             fprintf (stderr, "    clause has unassigned literal %d\n", lit);
         }
       else
@@ -562,7 +596,7 @@ propagate_clause (QRATPrePlus * qr, Clause *c)
           if ((LIT_NEG (lit) && var_a == ASSIGNMENT_FALSE) ||
               (LIT_POS (lit) && var_a == ASSIGNMENT_TRUE))
             {
-               if (qr->options.verbosity >= 2)
+               if (QRATPREPLUS_TRACE (qr))
                  fprintf (stderr, "    clause satisfied by lit %d and assignment %d\n", lit, var_a);
               return QBCP_STATE_UNKNOWN;
             }
@@ -573,16 +607,17 @@ propagate_clause (QRATPrePlus * qr, Clause *c)
   if (cnt_unassigned == 1)
     {
       assert (unassigned_lit);
-      handle_unit_clause (qr, c, unassigned_lit);
+      handle_unit_clause (qr, c, unassigned_lit, QRATPREPLUS_TRACE (qr));
     }
   else if (cnt_unassigned == 0)
     {
-      if (qr->options.verbosity >= 2)
+      if (QRATPREPLUS_TRACE (qr))
         fprintf (stderr, "    clause is conflicting\n");      
+      check_prop_cache_taint (qr, c);
       return QBCP_STATE_UNSAT;
     }
 
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     fprintf (stderr, "    state unknown after clause propagation\n");
   
   return QBCP_STATE_UNKNOWN;
@@ -602,14 +637,169 @@ find_unsatisfied_occ (QRATPrePlus * qr, ClausePtrStack *occs)
   return 0;
 }
 
+/* Remove redundant clauses from 'occs' while keeping the ordering. */
+static void
+purge_redundant_watched_occs (ClausePtrStack *occs)
+{
+  Clause **from, **to, **e;
+  for (from = to = occs->start, e = occs->top; from < e; from++)
+    if (!(*from)->redundant)
+      *to++ = *from;
+  occs->top = to;
+}
+
+/* Like the loop over watched occurrences in
+   'propagate_assigned_var_watched_lits (...)' but for formulas with a
+   single existential qblock, where QBCP is plain BCP. Only the watcher
+   at falsified literal 'false_lit' is moved, to any unassigned literal,
+   and 'c' is removed from 'occs' at its current position. All
+   assignments are retracted after QBCP, hence any two unassigned
+   literals can be watched, but the left watcher is kept at the smaller
+   index. */
+static QRATPREPLUS_KERNEL_INLINE QBCPState
+propagate_watched_occs_propositional (QRATPrePlus * qr, LitID false_lit,
+                                      ClausePtrStack *occs, const int trace)
+{
+  assert (qr->propositional);
+  QBCPState state = QBCP_STATE_UNKNOWN;
+  Clause **occ_p;
+  for (occ_p = occs->start; occ_p < occs->top && state == QBCP_STATE_UNKNOWN;)
+    {
+      Clause *c = *occ_p;
+      /* Must ignore tested clause and also redundant clauses. */
+      if (c->ignore_in_qbcp || c->redundant)
+        {
+          occ_p++;
+          continue;
+        }
+
+      if (qr->is_worker)
+        record_used_clause (qr, c);
+      qr->qbcp_cur_props++;
+
+      if (trace)
+        {
+          fprintf (stderr, "  propagate clause ID %u by BCP: ", c->id);
+          print_lits (qr, stderr, c->lits, c->num_lits, 1);
+        }
+
+      assert (c->num_lits >= 2);
+      assert (c->lw_index < c->rw_index);
+      unsigned int false_index, other_index;
+      if (c->lits[c->lw_index] == false_lit)
+        {
+          false_index = c->lw_index;
+          other_index = c->rw_index;
+        }
+      else
+        {
+          false_index = c->rw_index;
+          other_index = c->lw_index;
+        }
+      assert (c->lits[false_index] == false_lit);
+
+      LitID other_lit = c->lits[other_index];
+      Var *other_var = LIT2VARPTR (qr->pcnf.vars, other_lit);
+      if ((LIT_NEG (other_lit) && other_var->assignment == ASSIGNMENT_FALSE) ||
+          (LIT_POS (other_lit) && other_var->assignment == ASSIGNMENT_TRUE))
+        {
+          assert (is_clause_satisfied (qr, c));
+          occ_p++;
+          continue;
+        }
+
+      /* Find a new watcher which is not falsified, starting from the end
+         of the clause like in the general case. */
+      unsigned int new_index = WATCHED_LIT_INVALID_INDEX;
+      LitID *p, *e;
+      for (e = c->lits, p = e + c->num_lits - 1; e <= p; p--)
+        {
+          LitID lit = *p;
+          Var *v = LIT2VARPTR (qr->pcnf.vars, lit);
+          if (v->assignment == ASSIGNMENT_UNDEF)
+            {
+              if ((unsigned int) (p - e) != other_index)
+                {
+                  new_index = p - e;
+                  break;
+                }
+            }
+          else if ((LIT_NEG (lit) && v->assignment == ASSIGNMENT_FALSE) ||
+                   (LIT_POS (lit) && v->assignment == ASSIGNMENT_TRUE))
+            {
+              new_index = WATCHED_LIT_CLAUSE_SAT;
+              break;
+            }
+        }
+
+      if (new_index == WATCHED_LIT_CLAUSE_SAT)
+        {
+          assert (is_clause_satisfied (qr, c));
+          occ_p++;
+        }
+      else if (new_index == WATCHED_LIT_INVALID_INDEX)
+        {
+          if (other_var->assignment == ASSIGNMENT_UNDEF)
+            handle_unit_clause (qr, c, other_lit, trace);
+          else
+            {
+              assert (is_clause_empty (qr, c));
+              check_prop_cache_taint (qr, c);
+              state = QBCP_STATE_UNSAT;
+            }
+          occ_p++;
+        }
+      else
+        {
+          /* Move watcher and overwrite current entry by last one, which
+             is visited next. */
+          assert (new_index < c->num_lits);
+          *occ_p = POP_STACK (*occs);
+          if (false_index == c->lw_index)
+            c->lw_index = new_index;
+          else
+            c->rw_index = new_index;
+          if (c->lw_index > c->rw_index)
+            {
+              unsigned int tmp = c->lw_index;
+              c->lw_index = c->rw_index;
+              c->rw_index = tmp;
+            }
+          LitID new_lit = c->lits[new_index];
+          Var *new_var = LIT2VARPTR (qr->pcnf.vars, new_lit);
+          if (LIT_NEG (new_lit))
+            PUSH_STACK (qr->mm, new_var->watched_neg_occ_clauses, c);
+          else
+            PUSH_STACK (qr->mm, new_var->watched_pos_occ_clauses, c);
+        }
+    }
+
+  return state;
+}
+
 /* Like 'propagate_assigned_var (...)' but based on watched literals. */
-static QBCPState
-propagate_assigned_var_watched_lits (QRATPrePlus * qr, Var * var)
+static QRATPREPLUS_KERNEL_INLINE QBCPState
+propagate_assigned_var_watched_lits (QRATPrePlus * qr, Var * var,
+                                     const int no_eabs,
+                                     const int propositional,
+                                     const int trace)
 {
   assert (var->assignment != ASSIGNMENT_UNDEF);
   assert (!var->propagated);
 
-  if (qr->options.verbosity >= 2)
+  /* Redundant clauses are skipped during propagation, but we remove them
+     from the watched occurrences once there are too many of them. */
+  if (var->cnt_redundant_watched &&
+      var->cnt_redundant_watched * QRATPLUS_WATCHED_PURGE_RATIO >=
+      COUNT_STACK (var->watched_neg_occ_clauses) +
+      COUNT_STACK (var->watched_pos_occ_clauses))
+    {
+      purge_redundant_watched_occs (&var->watched_neg_occ_clauses);
+      purge_redundant_watched_occs (&var->watched_pos_occ_clauses);
+      var->cnt_redundant_watched = 0;
+    }
+
+  if (trace)
     {
       fprintf (stderr, "  propagate assignment: %d\n",
                var->assignment == ASSIGNMENT_FALSE ? -var->id : var->id);
@@ -620,6 +810,17 @@ propagate_assigned_var_watched_lits (QRATPrePlus * qr, Var * var)
   /* Check clauses shortened by assignment to detect units and conflicts. */
   ClausePtrStack *occs = var->assignment == ASSIGNMENT_FALSE ?
     &var->watched_pos_occ_clauses : &var->watched_neg_occ_clauses; 
+
+  if (propositional)
+    {
+      state = propagate_watched_occs_propositional
+        (qr, var->assignment == ASSIGNMENT_FALSE ? (LitID) var->id :
+         -(LitID) var->id, occs, trace);
+      if (state == QBCP_STATE_UNKNOWN)
+        var->propagated = 1;
+      return state;
+    }
+
   /* Updating watched literals will modify the list of occurrences. Keep track
      of occs-count to make sure we fully traverse the modified list. */
   unsigned int occs_cnt = (unsigned int) COUNT_STACK (*occs);
@@ -631,7 +832,7 @@ propagate_assigned_var_watched_lits (QRATPrePlus * qr, Var * var)
       /* Must ignore tested clause and also redundant clauses. */
       if (!c->ignore_in_qbcp && !c->redundant)
         {
-          state = propagate_clause_watched_lits (qr, c);
+          state = propagate_clause_watched_lits (qr, c, no_eabs, trace);
           if (occs_cnt != COUNT_STACK (*occs))
             {
               /* Last entry of 'occs' has been used to overwrite current
@@ -656,7 +857,7 @@ assign_vars_from_unit_input_clauses (QRATPrePlus *qr)
 {
   QBCPState state = QBCP_STATE_UNKNOWN;
 
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     fprintf (stderr, "  Assigning variables from unit input clauses\n");   
   
   Clause **cp, **ce;
@@ -683,30 +884,31 @@ assign_vars_from_tested_clause (QRATPrePlus *qr, Clause *c, LitID lit)
   const Nesting pivot_nesting = lit ? 
     LIT2VARPTR (qr->pcnf.vars, lit)->qblock->nesting : UINT_MAX;
 
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     fprintf (stderr, "  Assigning variables from tested clause\n");   
   
-  /* Collect assignments from: 'c \ {lit}'. */
+  /* Collect assignments from: 'c \ {lit}'. Ignore literals inner to the
+     pivot, if enabled. */
+  Nesting *nestings = CLAUSE_NESTINGS (c);
   LitID *p, *e;
-  for (p = c->lits, e = p + c->num_lits;
+  for (p = c->lits, e = p + (qr->options.ignore_inner_lits ?
+                             get_nesting_cutoff (c, pivot_nesting) : c->num_lits);
        p < e && state == QBCP_STATE_UNKNOWN; p++)
     {
       LitID cl = *p;
       if (cl != lit)
         {
           Var *cl_var = LIT2VARPTR (qr->pcnf.vars, cl);
-
-          /* Ignore literals inner to the pivot. */
-          if (qr->options.ignore_inner_lits && 
-              cl_var->qblock->nesting > pivot_nesting)
-            continue;
+          Nesting cl_nesting = nestings[p - c->lits];
+          assert (cl_nesting == cl_var->qblock->nesting);
 
 	  /* Compute maximum nesting over initially assigned variables. */
-	  if (cl_var->qblock->nesting > qr->eabs_nesting_aux)
-	    qr->eabs_nesting_aux = cl_var->qblock->nesting;
+	  if (cl_nesting > qr->eabs_nesting_aux)
+	    qr->eabs_nesting_aux = cl_nesting;
           if (cl_var->assignment == ASSIGNMENT_UNDEF)
             assign_and_enqueue (qr, cl_var, LIT_NEG (cl) ?
-                                ASSIGNMENT_TRUE : ASSIGNMENT_FALSE);
+                                ASSIGNMENT_TRUE : ASSIGNMENT_FALSE,
+                                QRATPREPLUS_TRACE (qr));
           else
             {
               /* Catch double and conflicting assignments of 'cl_var',
@@ -727,43 +929,42 @@ assign_vars_from_other_clause (QRATPrePlus *qr, Clause *occ, LitID lit)
 {
   QBCPState state = QBCP_STATE_UNKNOWN;
 
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     fprintf (stderr, "  Assigning variables from other (occ) clauses\n");   
   
   Var *var = LIT2VARPTR (qr->pcnf.vars, lit);
   const Nesting nesting = var->qblock->nesting;
   
   /* Collect assignments from: all lits in 'occ' from qblock smaller or
-     equal to qblock of 'lit' except in '\neg lit'. */
+     equal to qblock of 'lit' except in '\neg lit'. Literals are sorted,
+     hence these literals form a prefix of 'occ->lits'. */
+  Nesting *nestings = CLAUSE_NESTINGS (occ);
   LitID *p, *e;
-  for (p = occ->lits, e = p + occ->num_lits; p < e; p++)
+  for (p = occ->lits, e = p + get_nesting_cutoff (occ, nesting); p < e; p++)
     {
       LitID cl = *p;
-      Var *cl_var = LIT2VARPTR (qr->pcnf.vars, cl);
       if (cl != -lit)
         {
-          /* Literals are sorted, hence abort if literal from qblock
-             larger than that of 'lit' is seen. */
-          if (cl_var->qblock->nesting <= nesting)
+          Var *cl_var = LIT2VARPTR (qr->pcnf.vars, cl);
+          Nesting cl_nesting = nestings[p - occ->lits];
+          assert (cl_nesting == cl_var->qblock->nesting);
+          assert (cl_nesting <= nesting);
+          /* Compute maximum nesting over initially assigned variables. */
+          if (cl_nesting > qr->eabs_nesting_aux)
+            qr->eabs_nesting_aux = cl_nesting;
+          if (cl_var->assignment == ASSIGNMENT_UNDEF)
+            assign_and_enqueue (qr, cl_var, LIT_NEG (cl) ?
+                                ASSIGNMENT_TRUE : ASSIGNMENT_FALSE,
+                                QRATPREPLUS_TRACE (qr));
+          else
             {
-	      /* Compute maximum nesting over initially assigned variables. */
-	      if (cl_var->qblock->nesting > qr->eabs_nesting_aux)
-		qr->eabs_nesting_aux = cl_var->qblock->nesting;
-              if (cl_var->assignment == ASSIGNMENT_UNDEF)
-                assign_and_enqueue (qr, cl_var, LIT_NEG (cl) ?
-                                    ASSIGNMENT_TRUE : ASSIGNMENT_FALSE);
-              else
-                {
-                  /* Catch double and conflicting assignments of 'cl_var',
-                     which may happen if 'cl_var' appears in unit input, or if
-                     outer resolvent is tautological. */
-                  if ((LIT_NEG (cl) && cl_var->assignment == ASSIGNMENT_FALSE) ||
-                      (LIT_POS (cl) && cl_var->assignment == ASSIGNMENT_TRUE))
-                    state = QBCP_STATE_UNSAT;
-                }
+              /* Catch double and conflicting assignments of 'cl_var',
+                 which may happen if 'cl_var' appears in unit input, or if
+                 outer resolvent is tautological. */
+              if ((LIT_NEG (cl) && cl_var->assignment == ASSIGNMENT_FALSE) ||
+                  (LIT_POS (cl) && cl_var->assignment == ASSIGNMENT_TRUE))
+                state = QBCP_STATE_UNSAT;
             }
-          else
-            break;
         }
     }
 
@@ -844,20 +1045,25 @@ assert_watched_lit_state_before_assigning (QRATPrePlus *qr)
 {
   Clause *c;
   for (c = qr->pcnf.clauses.first; c; c = c->link.next)
-    assert_check_clause_watched_lits (qr, c);
+    /* Redundant clauses may have been purged from watched occurrences. */
+    if (!c->redundant)
+      assert_check_clause_watched_lits (qr, c);
 }
 
-static QBCPState
-qbcp (QRATPrePlus * qr)
+static QRATPREPLUS_KERNEL_INLINE QBCPState
+qbcp_aux (QRATPrePlus * qr, const int no_eabs, const int propositional,
+          const int trace)
 {
   qr->qbcp_total_calls++;
-  if (!qr->options.no_eabs)
+  if (!no_eabs)
     qr->qbcp_total_eabs_nestings += qr->eabs_nesting;
 
   assert (EMPTY_STACK (qr->lw_update_clauses));
+  assert (!no_eabs || qr->options.no_eabs || propositional);
+  assert (!propositional || qr->propositional);
   QBCPState state = QBCP_STATE_UNKNOWN;
 
-  if (qr->options.verbosity >= 2)
+  if (trace)
     fprintf (stderr, "  Starting QBCP with EABS nesting %u\n", qr->eabs_nesting);
   
   /* NOTE: memory region of QBCP queue might be enlarged during
@@ -880,7 +1086,8 @@ qbcp (QRATPrePlus * qr)
 
       Var *prop_var = VARID2VARPTR (qr->pcnf.vars, *qbcp_p);
 
-      state = propagate_assigned_var_watched_lits (qr, prop_var);
+      state = propagate_assigned_var_watched_lits (qr, prop_var, no_eabs,
+                                                   propositional, trace);
       
       /* Reassign pointers as queue may have grown and memory enlarged. */
       qbcp_e = qr->qbcp_queue.top;
@@ -892,9 +1099,254 @@ qbcp (QRATPrePlus * qr)
 #endif
 #endif
 
+  /* When using abstraction, must make sure that right watcher is always
+     at an existential literal. Update watchers in collected clauses. */
+  if (!no_eabs)
+    retract_re_init_lit_watchers (qr);
+
   return state;
 }
 
+/* Instances of 'qbcp_aux' for the main option combinations, where the
+   tests of these options in the propagation loops are resolved at
+   compile time. All variables of a propositional formula are existential,
+   hence prefix abstraction is not needed. Kernels with trace output test
+   the verbosity level at run time, unless trace output is removed by
+   'QRATPREPLUS_NO_TRACE'. */
+#define DEFINE_QBCP_KERNEL(name, no_eabs, propositional, trace)        \
+  static QBCPState                                                      \
+  name (QRATPrePlus * qr)                                               \
+  {                                                                     \
+    return qbcp_aux (qr, no_eabs, propositional, trace);                \
+  }
+
+DEFINE_QBCP_KERNEL (qbcp_eabs, 0, 0, 0)
+DEFINE_QBCP_KERNEL (qbcp_no_eabs, 1, 0, 0)
+DEFINE_QBCP_KERNEL (qbcp_propositional, 1, 1, 0)
+DEFINE_QBCP_KERNEL (qbcp_eabs_trace, 0, 0, QRATPREPLUS_TRACE (qr))
+DEFINE_QBCP_KERNEL (qbcp_no_eabs_trace, 1, 0, QRATPREPLUS_TRACE (qr))
+DEFINE_QBCP_KERNEL (qbcp_propositional_trace, 1, 1, QRATPREPLUS_TRACE (qr))
+
+/* ---------- START: PROPAGATION CACHE ---------- */
+
+/* In a QRAT check of clause 'c' on pivot 'lit' and occurrence 'occ', the
+   assignment from 'occ' only depends on 'occ' and 'lit'. The propagation
+   cache keeps the result of QBCP on that assignment alone, computed under
+   the abstraction level of the check and without using clauses containing
+   'lit', hence not using 'c'. If that propagation is conflicting or
+   satisfies a literal of 'c' then the check succeeds, provided that the
+   assignment from 'c' does not assign universal variables which are not
+   abstracted: otherwise, satisfied universal literals may prevent unit
+   propagations that were done in the cached propagation. */
+
+static unsigned int
+hash_prop_cache_key (ClauseID occ_id, LitID pivot, Nesting nesting)
+{
+  return occ_id * 2654435761u ^ (unsigned int) pivot * 2246822519u ^
+    nesting * 3266489917u;
+}
+
+/* Start a new epoch of the propagation cache, i.e., make all entries
+   invalid, if the formula has changed since the current epoch
+   started. Also if too many literals are cached. */
+static void
+update_prop_cache_epoch (QRATPrePlus * qr)
+{
+  if (qr->prop_cache_epoch &&
+      qr->prop_cache_redundant_clauses == COUNT_STACK (qr->redundant_clauses) &&
+      qr->prop_cache_clause_lengths == qr->total_clause_lengths &&
+      COUNT_STACK (qr->prop_cache_lits) <= QRATPLUS_PROP_CACHE_MAX_LITS)
+    return;
+  qr->prop_cache_epoch++;
+  qr->cnt_prop_cache = 0;
+  RESET_STACK (qr->prop_cache_lits);
+  qr->prop_cache_redundant_clauses = COUNT_STACK (qr->redundant_clauses);
+  qr->prop_cache_clause_lengths = qr->total_clause_lengths;
+}
+
+/* Returns the slot of the entry with the given key, or the empty slot where
+   that entry has to be inserted. */
+static PropCacheEntry *
+find_prop_cache_slot (QRATPrePlus * qr, ClauseID occ_id, LitID pivot,
+                      Nesting nesting)
+{
+  assert (qr->size_prop_cache > qr->cnt_prop_cache);
+  unsigned int mask = qr->size_prop_cache - 1;
+  unsigned int i = hash_prop_cache_key (occ_id, pivot, nesting) & mask;
+  PropCacheEntry *e;
+  for (e = qr->prop_cache + i; e->epoch == qr->prop_cache_epoch;
+       e = qr->prop_cache + (i = (i + 1) & mask))
+    if (e->occ_id == occ_id && e->pivot == pivot && e->nesting == nesting)
+      break;
+  return e;
+}
+
+/* Make sure there is space for another entry in the propagation cache,
+   which is at most half full. */
+static void
+enlarge_prop_cache (QRATPrePlus * qr)
+{
+  if (2 * (qr->cnt_prop_cache + 1) <= qr->size_prop_cache)
+    return;
+  PropCacheEntry *old = qr->prop_cache, *e;
+  unsigned int old_size = qr->size_prop_cache;
+  qr->size_prop_cache = old_size ? 2 * old_size : QRATPLUS_PROP_CACHE_INIT_SIZE;
+  qr->prop_cache = mm_malloc (qr->mm, qr->size_prop_cache * sizeof (PropCacheEntry));
+  memset (qr->prop_cache, 0, qr->size_prop_cache * sizeof (PropCacheEntry));
+  for (e = old; e < old + old_size; e++)
+    if (e->epoch == qr->prop_cache_epoch)
+      *find_prop_cache_slot (qr, e->occ_id, e->pivot, e->nesting) = *e;
+  mm_free (qr->mm, old, old_size * sizeof (PropCacheEntry));
+}
+
+/* Propagate the assignment derived from 'occ' on pivot 'lit' under
+   abstraction level 'nesting' and store the result in 'entry'. */
+static void
+compute_prop_cache_entry (QRATPrePlus * qr, Clause *occ, LitID lit,
+                          Nesting nesting, PropCacheEntry *entry)
+{
+  assert (EMPTY_STACK (qr->qbcp_queue));
+  assert (qr->eabs_nesting == UINT_MAX);
+  assert (qr->eabs_nesting_aux == 0);
+  assert (qr->qbcp_cur_props == 0);
+
+  qr->prop_cache_pivot = lit;
+  qr->prop_cache_tainted = 0;
+
+  /* Assign variables like in 'qrat_qbcp_check'. */
+  QBCPState state;
+  if ((state = assign_vars_from_unit_input_clauses (qr)) == QBCP_STATE_UNKNOWN &&
+      (state = assign_vars_from_other_clause (qr, occ, lit)) == QBCP_STATE_UNKNOWN)
+    {
+      qr->eabs_nesting = nesting;
+      state = qr->qbcp_kernel (qr);
+    }
+
+  entry->conflict = (state == QBCP_STATE_UNSAT);
+  entry->tainted = qr->prop_cache_tainted;
+  entry->offset = COUNT_STACK (qr->prop_cache_lits);
+  if (!entry->conflict && !entry->tainted)
+    {
+      VarID *qp, *qe;
+      for (qp = qr->qbcp_queue.start, qe = qr->qbcp_queue.top; qp < qe; qp++)
+        {
+          Var *var = VARID2VARPTR (qr->pcnf.vars, *qp);
+          PUSH_STACK (qr->mm, qr->prop_cache_lits,
+                      var->assignment == ASSIGNMENT_TRUE ?
+                      (LitID) var->id : -(LitID) var->id);
+        }
+    }
+  entry->cnt = COUNT_STACK (qr->prop_cache_lits) - entry->offset;
+
+  retract (qr);
+  qr->prop_cache_pivot = 0;
+  qr->eabs_nesting = UINT_MAX;
+  qr->eabs_nesting_aux = 0;
+  qr->qbcp_total_props += qr->qbcp_cur_props;
+  qr->qbcp_cur_props = 0;
+}
+
+/* Returns the entry of the propagation cache for 'occ', 'lit', and
+   'nesting', which is computed if not cached yet. */
+static PropCacheEntry *
+get_prop_cache_entry (QRATPrePlus * qr, Clause *occ, LitID lit,
+                      Nesting nesting)
+{
+  update_prop_cache_epoch (qr);
+  qr->cnt_prop_cache_lookups++;
+  if (qr->size_prop_cache)
+    {
+      PropCacheEntry *e = find_prop_cache_slot (qr, occ->id, lit, nesting);
+      if (e->epoch == qr->prop_cache_epoch)
+        {
+          qr->cnt_prop_cache_hits++;
+          return e;
+        }
+    }
+
+  PropCacheEntry entry;
+  compute_prop_cache_entry (qr, occ, lit, nesting, &entry);
+  entry.occ_id = occ->id;
+  entry.pivot = lit;
+  entry.nesting = nesting;
+  entry.epoch = qr->prop_cache_epoch;
+  enlarge_prop_cache (qr);
+  PropCacheEntry *e = find_prop_cache_slot (qr, occ->id, lit, nesting);
+  assert (e->epoch != qr->prop_cache_epoch);
+  *e = entry;
+  qr->cnt_prop_cache++;
+  return e;
+}
+
+/* Returns nonzero iff the QRAT check of 'c' on pivot 'lit' and occurrence
+   'occ' succeeds by the propagation cache. Returns zero if the check
+   has to be done by QBCP. */
+static int
+is_qrat_check_decided_by_prop_cache (QRATPrePlus * qr, Clause *c, LitID lit,
+                                     Clause *occ)
+{
+  const Nesting pivot_nesting = LIT2VARPTR (qr->pcnf.vars, lit)->qblock->nesting;
+  Nesting *nestings = CLAUSE_NESTINGS (c);
+  unsigned int i, cutoff = qr->options.ignore_inner_lits ?
+    get_nesting_cutoff (c, pivot_nesting) : c->num_lits;
+
+  /* Compute the abstraction level of the check like in 'qrat_qbcp_check'. */
+  Nesting nesting = 0;
+  for (i = 0; i < cutoff; i++)
+    if (c->lits[i] != lit && nestings[i] > nesting)
+      nesting = nestings[i];
+  Nesting *occ_nestings = CLAUSE_NESTINGS (occ);
+  unsigned int occ_cutoff = get_nesting_cutoff (occ, pivot_nesting);
+  for (i = 0; i < occ_cutoff; i++)
+    if (occ->lits[i] != -lit && occ_nestings[i] > nesting)
+      nesting = occ_nestings[i];
+  if (qr->options.no_eabs)
+    nesting = UINT_MAX;
+  else if (!qr->options.no_eabs_improved_nesting && nesting > 0)
+    nesting--;
+
+  for (i = 0; i < cutoff; i++)
+    if (c->lits[i] != lit && nestings[i] > nesting &&
+        LIT2VARPTR (qr->pcnf.vars, c->lits[i])->qblock->type == QTYPE_FORALL)
+      return 0;
+
+  PropCacheEntry *e = get_prop_cache_entry (qr, occ, lit, nesting);
+  if (e->tainted)
+    return 0;
+  int result = e->conflict;
+
+  /* Check whether the cached assignment satisfies a literal of 'c' by
+     temporarily assigning the literals of 'c' to false. */
+  if (!result)
+    {
+      for (i = 0; i < cutoff; i++)
+        if (c->lits[i] != lit)
+          LIT2VARPTR (qr->pcnf.vars, c->lits[i])->assignment =
+            LIT_NEG (c->lits[i]) ? ASSIGNMENT_TRUE : ASSIGNMENT_FALSE;
+      LitID *p, *pe;
+      for (p = qr->prop_cache_lits.start + e->offset, pe = p + e->cnt;
+           p < pe && !result; p++)
+        {
+          Assignment a = LIT2VARPTR (qr->pcnf.vars, *p)->assignment;
+          if ((LIT_NEG (*p) && a == ASSIGNMENT_TRUE) ||
+              (LIT_POS (*p) && a == ASSIGNMENT_FALSE))
+            result = 1;
+        }
+      for (i = 0; i < cutoff; i++)
+        LIT2VARPTR (qr->pcnf.vars, c->lits[i])->assignment = ASSIGNMENT_UNDEF;
+    }
+
+  if (result)
+    {
+      qr->cnt_prop_cache_decided++;
+      if (QRATPREPLUS_TRACE (qr))
+        fprintf (stderr, "  QRAT check decided by propagation cache\n");
+    }
+  return result;
+}
+
+/* ---------- END: PROPAGATION CACHE ---------- */
+
 /* -------------------- START: PUBLIC FUNCTIONS -------------------- */
 
 /* Check if 'c' is an asymmetric tautology by negating the clause and
@@ -912,7 +1364,7 @@ qrat_qat_check (QRATPrePlus * qr, Clause *c)
   qr->qbcp_total_props += qr->qbcp_cur_props;
   qr->qbcp_cur_props = 0;
   
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     {
       fprintf (stderr, "Asymm. taut. check with internal QBCP on clause: ");
       print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -956,7 +1408,7 @@ qrat_qat_check (QRATPrePlus * qr, Clause *c)
   else
     assert (qr->eabs_nesting == UINT_MAX);
 
-  state = qbcp (qr);
+  state = qr->qbcp_kernel (qr);
 
   retract (qr);
   assert (c->ignore_in_qbcp);
@@ -993,7 +1445,7 @@ qrat_qbcp_check (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ)
   qr->qbcp_total_props += qr->qbcp_cur_props;
   qr->qbcp_cur_props = 0;
   
-  if (qr->options.verbosity >= 2)
+  if (QRATPREPLUS_TRACE (qr))
     {
       fprintf (stderr, "QRAT check with internal QBCP on clause: ");
       print_lits (qr, stderr, c->lits, c->num_lits, 1);
@@ -1001,6 +1453,16 @@ qrat_qbcp_check (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ)
       print_lits (qr, stderr, occ->lits, occ->num_lits, 1);
       fprintf (stderr, "  ... and pivot: %d\n", lit);
     }
+
+  /* The cache is used only if checks are exact, i.e., without propagation
+     limit. */
+  if (qr->options.prop_cache && !qr->is_worker &&
+      qr->limit_qbcp_cur_props == UINT_MAX &&
+      is_qrat_check_decided_by_prop_cache (qr, c, lit, occ))
+    {
+      qr->qrat_qbcp_successful_checks++;
+      return 1;
+    }
   
   assert (!c->redundant);
   assert (!c->ignore_in_qbcp);
@@ -1044,7 +1506,7 @@ qrat_qbcp_check (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ)
   else
     assert (qr->eabs_nesting == UINT_MAX);
 
-  state = qbcp (qr);
+  state = qr->qbcp_kernel (qr);
 
   retract (qr);
   assert (c->ignore_in_qbcp);
@@ -1070,4 +1532,15 @@ qrat_qbcp_check (QRATPrePlus * qr, Clause *c, LitID lit, Clause *occ)
   return (state == QBCP_STATE_UNSAT);
 }
 
+void
+select_qbcp_kernel (QRATPrePlus * qr)
+{
+  if (QRATPREPLUS_TRACE (qr))
+    qr->qbcp_kernel = qr->propositional ? qbcp_propositional_trace :
+      (qr->options.no_eabs ? qbcp_no_eabs_trace : qbcp_eabs_trace);
+  else
+    qr->qbcp_kernel = qr->propositional ? qbcp_propositional :
+      (qr->options.no_eabs ? qbcp_no_eabs : qbcp_eabs);
+}
+
 /* -------------------- END: PUBLIC FUNCTIONS -------------------- */
@@ -26,13 +26,10 @@
 
 #include "qratpreplus_internals.h"
 
-enum QBCPState
-{
-  QBCP_STATE_UNKNOWN = 0,
-  QBCP_STATE_UNSAT = 20
-};
-
-typedef enum QBCPState QBCPState;
+/* Select the variant of QBCP used by 'qrat_qat_check' and
+   'qrat_qbcp_check', depending on 'qr->propositional', option '--no-eabs',
+   and whether trace output is enabled. */
+void select_qbcp_kernel (QRATPrePlus * qr);
 
 int qrat_qat_check (QRATPrePlus * qr, Clause *c);
 
@@ -35,6 +35,9 @@
 #include "stack.h"
 #include "mem.h"
 #include "qbce_qrat_plus.h"
+#include "qbcp.h"
+#include "els.h"
+#include "components.h"
 #include "parse.h"
 #include "util.h"
 #include "qratpreplus.h"
@@ -77,15 +80,19 @@ cleanup (QRATPrePlus * qr)
          PCNF, if not already done so. */
       if (c->link.prev || c->link.next || c == qr->pcnf.clauses.first)
         UNLINK (qr->pcnf.clauses, c, link);
-      mm_free (qr->mm, c, sizeof (Clause) + c->size_lits * sizeof (LitID));
+      mm_free (qr->mm, c, CLAUSE_BYTES (c->size_lits));
     }
 
   DELETE_STACK (qr->mm, qr->parsed_literals);
   DELETE_STACK (qr->mm, qr->redundant_clauses);
   DELETE_STACK (qr->mm, qr->witness_clauses);
+  DELETE_STACK (qr->mm, qr->touched_vars);
+  DELETE_STACK (qr->mm, qr->dirty_vars);
   DELETE_STACK (qr->mm, qr->unit_input_clauses);
   DELETE_STACK (qr->mm, qr->qbcp_queue);
   DELETE_STACK (qr->mm, qr->lw_update_clauses);
+  DELETE_STACK (qr->mm, qr->prop_cache_lits);
+  mm_free (qr->mm, qr->prop_cache, qr->size_prop_cache * sizeof (PropCacheEntry));
 
   Var *vp, *ve;
   for (vp = qr->pcnf.vars, ve = vp + qr->pcnf.size_vars; vp < ve; vp++)
@@ -109,7 +116,7 @@ cleanup (QRATPrePlus * qr)
   for (c = qr->pcnf.clauses.first; c; c = cn)
     {
       cn = c->link.next;
-      mm_free (qr->mm, c, sizeof (Clause) + c->size_lits * sizeof (LitID));
+      mm_free (qr->mm, c, CLAUSE_BYTES (c->size_lits));
     }
 }
 
@@ -182,6 +189,30 @@ formula_has_non_redundant_clauses (QRATPrePlus *qr)
   return 0;
 }
 
+/* Recompute maximal occurrence count and clause length for printing
+   statistics. Unlike the totals, maxima are not maintained while
+   redundant clauses and literals are removed. */
+static void
+update_max_stats (QRATPrePlus *qr)
+{
+  qr->max_clause_length = 0;
+  Clause *c;
+  for (c = qr->pcnf.clauses.first; c; c = c->link.next)
+    if (c->num_lits > qr->max_clause_length)
+      qr->max_clause_length = c->num_lits;
+
+  qr->max_occ_cnt = 0;
+  Var *var, *vars_end;
+  for (var = qr->pcnf.vars, vars_end = var + qr->pcnf.size_vars; 
+       var < vars_end; var++)
+    {
+      if ((unsigned int) COUNT_STACK (var->neg_occ_clauses) > qr->max_occ_cnt)
+        qr->max_occ_cnt = (unsigned int) COUNT_STACK (var->neg_occ_clauses);
+      if ((unsigned int) COUNT_STACK (var->pos_occ_clauses) > qr->max_occ_cnt)
+        qr->max_occ_cnt = (unsigned int) COUNT_STACK (var->pos_occ_clauses);
+    }
+}
+
 static void
 clean_up_empty_qblocks (QRATPrePlus *qr)
 {
@@ -223,6 +254,8 @@ static void
 set_default_options (QRATPrePlus * qr)
 {
   qr->options.seed = 0;
+  qr->options.threads = 1;
+  qr->options.split_occs_threshold = 1000;
   qr->options.in_filename = 0;
   qr->options.in = stdin;
   /* Set default limits. */
@@ -230,12 +263,14 @@ set_default_options (QRATPrePlus * qr)
   qr->limit_max_occ_cnt = UINT_MAX;
   qr->limit_max_clause_len = UINT_MAX;
   qr->limit_min_clause_len = 0;
+  qr->limit_max_resolvents = UINT_MAX;
   /* Setting 'qr->eabs_nesting' to UINT_MAX has the effect that ALL
      variables are treating as existentially quantified,. This way, we
      obtain a full propositional abstraction of the given QBF. */
   qr->eabs_nesting = UINT_MAX;
   qr->eabs_nesting_aux = 0;
   qr->limit_global_iterations = UINT_MAX;
+  qr->options.qbce_check_taut_by_nesting = 1;
 }
 
 #ifndef NDEBUG
@@ -246,6 +281,10 @@ assert_formula_integrity (QRATPrePlus * qr)
   for (c = qr->pcnf.clauses.first; c; c = c->link.next)
     {
       assert_lits_sorted (qr, c->lits, c->lits + c->num_lits);
+      unsigned int i;
+      for (i = 0; i < c->num_lits; i++)
+        assert (CLAUSE_NESTINGS (c)[i] ==
+                LIT2VARPTR (qr->pcnf.vars, c->lits[i])->qblock->nesting);
       LitID last = c->num_lits ? c->lits[c->num_lits - 1] : 0;
       Var *last_var = last ? LIT2VARPTR (qr->pcnf.vars, last) : 0;
       assert (!last_var || last_var->qblock->type == QTYPE_EXISTS);
@@ -285,6 +324,7 @@ qratpreplus_create ()
   MemMan *mm = mm_create ();
   QRATPrePlus * qr = mm_malloc (mm, sizeof (QRATPrePlus));
   qr->mm = mm;
+  select_simd_kernels ();
   set_default_options (qr);
   qr->start_time = time_stamp ();
   return qr;
@@ -319,6 +359,30 @@ qratpreplus_configure (QRATPrePlus * qr, char *opt_str)
     {
       qr->options.no_qrate = 1;
     }
+  else if (!strcmp (opt_str, "--subsumption"))
+    {
+      qr->options.subsumption = 1;
+    }
+  else if (!strcmp (opt_str, "--subsumption-iterations"))
+    {
+      qr->options.subsumption_iterations = 1;
+    }
+  else if (!strcmp (opt_str, "--components"))
+    {
+      qr->options.components = 1;
+    }
+  else if (!strcmp (opt_str, "--pure-literals"))
+    {
+      qr->options.pure_literals = 1;
+    }
+  else if (!strcmp (opt_str, "--subst-equiv-lits"))
+    {
+      qr->options.subst_equiv_lits = 1;
+    }
+  else if (!strcmp (opt_str, "--prop-cache"))
+    {
+      qr->options.prop_cache = 1;
+    }
   else if (!strcmp (opt_str, "--no-eabs"))
     {
       qr->options.no_eabs = 1;
@@ -327,6 +391,10 @@ qratpreplus_configure (QRATPrePlus * qr, char *opt_str)
     {
       qr->options.no_eabs_improved_nesting = 1;
     }
+  else if (!strcmp (opt_str, "--no-propositional-path"))
+    {
+      qr->options.no_propositional_path = 1;
+    }
   else if (!strcmp (opt_str, "--formula-stats"))
     {
       qr->options.formula_stats = 1;
@@ -347,10 +415,18 @@ qratpreplus_configure (QRATPrePlus * qr, char *opt_str)
     {
       qr->options.permute = 1;
     }
+  else if (!strcmp (opt_str, "--group-checks"))
+    {
+      qr->options.group_checks = 1;
+    }
   else if (!strcmp (opt_str, "--qbce-check-taut-by-nesting"))
     {
       qr->options.qbce_check_taut_by_nesting = 1;
     }
+  else if (!strcmp (opt_str, "--no-qbce-check-taut-by-nesting"))
+    {
+      qr->options.qbce_check_taut_by_nesting = 0;
+    }
   else if (!strncmp (opt_str, "--limit-qbcp-cur-props=", strlen ("--limit-qbcp-cur-props=")))
     {
       opt_str += strlen ("--limit-qbcp-cur-props=");
@@ -384,6 +460,14 @@ qratpreplus_configure (QRATPrePlus * qr, char *opt_str)
       else
         result = "Expecting number after '--soft-time-limit='";
     }
+  else if (!strncmp (opt_str, "--min-elim-rate=", strlen ("--min-elim-rate=")))
+    {
+      opt_str += strlen ("--min-elim-rate=");
+      if (isnumstr (opt_str))
+        qr->min_elim_rate = atoi (opt_str);
+      else
+        result = "Expecting number after '--min-elim-rate='";
+    }
   else if (!strncmp (opt_str, "--limit-max-occ-cnt=", strlen ("--limit-max-occ-cnt=")))
     {
       opt_str += strlen ("--limit-max-occ-cnt=");
@@ -392,6 +476,32 @@ qratpreplus_configure (QRATPrePlus * qr, char *opt_str)
       else
         result = "Expecting number after '--limit-max-occ-cnt='";
     }
+  else if (!strncmp (opt_str, "--occ-order=", strlen ("--occ-order=")))
+    {
+      opt_str += strlen ("--occ-order=");
+      if (!strcmp (opt_str, "none"))
+        qr->options.occ_order = OCC_ORDER_NONE;
+      else if (!strcmp (opt_str, "short"))
+        qr->options.occ_order = OCC_ORDER_SHORT;
+      else if (!strcmp (opt_str, "mtf"))
+        qr->options.occ_order = OCC_ORDER_MTF;
+      else if (!strcmp (opt_str, "inner"))
+        qr->options.occ_order = OCC_ORDER_INNER;
+      else
+        result = "Expecting one of 'none', 'short', 'mtf', 'inner' after '--occ-order='";
+    }
+  else if (!strcmp (opt_str, "--per-pivot-occ-limit"))
+    {
+      qr->options.per_pivot_occ_limit = 1;
+    }
+  else if (!strncmp (opt_str, "--limit-max-resolvents=", strlen ("--limit-max-resolvents=")))
+    {
+      opt_str += strlen ("--limit-max-resolvents=");
+      if (isnumstr (opt_str))
+        qr->limit_max_resolvents = atoi (opt_str);
+      else
+        result = "Expecting number after '--limit-max-resolvents='";
+    }
   else if (!strncmp (opt_str, "--limit-max-clause-len=", strlen ("--limit-max-clause-len=")))
     {
       opt_str += strlen ("--limit-max-clause-len=");
@@ -418,10 +528,38 @@ qratpreplus_configure (QRATPrePlus * qr, char *opt_str)
       else
         result = "Expecting number after '--seed='";
     }
+  else if (!strncmp (opt_str, "--threads=", strlen ("--threads=")))
+    {
+      opt_str += strlen ("--threads=");
+      if (isnumstr (opt_str) && atoi (opt_str) > 0)
+        qr->options.threads = atoi (opt_str);
+      else
+        result = "Expecting positive number after '--threads='";
+    }
+  else if (!strncmp (opt_str, "--split-occs-threshold=", strlen ("--split-occs-threshold=")))
+    {
+      opt_str += strlen ("--split-occs-threshold=");
+      if (isnumstr (opt_str))
+        qr->options.split_occs_threshold = atoi (opt_str);
+      else
+        result = "Expecting number after '--split-occs-threshold='";
+    }
+  else if (!strcmp (opt_str, "--deterministic"))
+    {
+      qr->options.deterministic = 1;
+    }
   else if (!strcmp (opt_str, "--no-qat"))
     {
       qr->options.no_qat = 1;
     }
+  else if (!strcmp (opt_str, "--priority-schedule"))
+    {
+      qr->options.priority_schedule = 1;
+    }
+  else if (!strcmp (opt_str, "--incremental-global-iterations"))
+    {
+      qr->options.incremental_global_iterations = 1;
+    }
     else if (!strcmp (opt_str, "-v"))
       {
         qr->options.verbosity++;
@@ -521,6 +659,8 @@ qratpreplus_print_stats (QRATPrePlus *qr, FILE *file)
     fprintf (file, "  soft time limit: %d (time exceeded: %s)\n", qr->soft_time_limit, qr->time_exceeded ? "yes" : "no");
       
   fprintf (file, "  Global iterations: %d\n", qr->cnt_global_iterations);
+  fprintf (file, "  Diminishing returns cutoffs: %u, estimated time saved: %f\n",
+           qr->cnt_diminishing_cutoffs, qr->diminishing_time_saved);
   fprintf (file, "  CE iterations: %d\n", qr->cnt_qbce_iterations);
   fprintf (file, "  CE checks: %llu ( %f %% of initial CNF)\n", 
            qr->cnt_qbce_checks, qr->actual_num_clauses ? 
@@ -528,14 +668,37 @@ qratpreplus_print_stats (QRATPrePlus *qr, FILE *file)
   fprintf (file, "  CE: %d redundant clauses of total %d clauses ( %f %% of initial CNF)\n",
            qr->cnt_redundant_clauses, qr->actual_num_clauses, qr->actual_num_clauses ? 
            ((qr->cnt_redundant_clauses / (float)qr->actual_num_clauses) * 100) : 0);
+  fprintf (file, "  CE speculative checks repeated: %llu ( %f %% of CE checks)\n",
+           qr->cnt_speculative_rechecks, qr->cnt_qbce_checks ?
+           ((qr->cnt_speculative_rechecks / (float)qr->cnt_qbce_checks) * 100) : 0);
+  fprintf (file, "  QRAT pivots with outer resolvents checked in parallel: %llu\n",
+           qr->cnt_split_occ_checks);
+  fprintf (file, "  Avg. position of witness in occurrences: %f ( %llu failed pivots)\n",
+           qr->cnt_witness_positions ? qr->sum_witness_positions /
+           (float) qr->cnt_witness_positions : 0, qr->cnt_witness_positions);
+  fprintf (file, "  Pivots skipped due to occurrence limit: %llu\n",
+           qr->cnt_pivots_over_occ_limit);
+  fprintf (file, "  Clause checks stopped due to resolvent limit: %llu\n",
+           qr->cnt_resolvent_limit_reached);
   fprintf (file, "  QRAT propagations: total %llu avg. %f per check, total %llu checks of outer res.\n", 
            qr->qbcp_total_props, qr->qrat_qbcp_checks ? (float)qr->qbcp_total_props /  qr->qrat_qbcp_checks : 0, qr->qrat_qbcp_checks);
   fprintf (file, "  QRAT success. propagations: total %llu avg. %f per check, total %llu checks of outer res.\n", 
            qr->qbcp_successful_checks_props, qr->qrat_qbcp_successful_checks ? (float)qr->qbcp_successful_checks_props /  
            qr->qrat_qbcp_successful_checks : 0, qr->qrat_qbcp_successful_checks);
+  fprintf (file, "  Subsumed clauses: %u\n", qr->cnt_subsumed_clauses);
+  fprintf (file, "  Components: %u, largest: %u clauses, slowest: %f sec, total: %f sec\n",
+           qr->cnt_components, qr->max_component_clauses,
+           qr->max_component_time, qr->components_time);
+  fprintf (file, "  Pure literals: %u clauses, %u universal literals\n",
+           qr->cnt_pure_lit_clauses, qr->cnt_pure_lit_univ_lits);
+  fprintf (file, "  Equivalent literal substitution: %u variables, %u tautological clauses deleted\n",
+           qr->cnt_els_substituted_vars, qr->cnt_els_deleted_clauses);
+  fprintf (file, "  QRAT propagation cache: %llu lookups, %llu hits, %llu checks decided\n",
+           qr->cnt_prop_cache_lookups, qr->cnt_prop_cache_hits, qr->cnt_prop_cache_decided);
 
   fprintf (file, "  QRAT  propagation limit reached: %u times in total %llu checks, with limit set to %u\n", 
            qr->limit_qbcp_cur_props_reached, qr->qrat_qbcp_checks, qr->limit_qbcp_cur_props);
+  update_max_stats (qr);
   fprintf (file, "  Occ. count: max %u avg %f per used var, total %u used vars\n", qr->max_occ_cnt, 
            qr->actual_num_vars ? qr->total_occ_cnts / (float)qr->actual_num_vars : 0, qr->actual_num_vars);
   fprintf (file, "  Clause length: max %u avg %f per clause, total %u clauses\n", qr->max_clause_length, 
@@ -547,15 +710,21 @@ qratpreplus_print_stats (QRATPrePlus *qr, FILE *file)
   fprintf (file, "  QBCP total assignments %llu avg %f %% per QBCP call\n", qr->total_assignments,  
            qr->qbcp_total_calls ? (qr->total_assignments / (float)qr->qbcp_total_calls) : 0);
 
-  fprintf (file, "  CE total OR checks %llu avg OR checks per CE check %f total lits seen %llu avg lits seen per OR check %f\n", 
+  fprintf (file, "  CE total OR checks %llu avg OR checks per CE check %f total lits seen %llu avg lits seen per OR check %f sig. filtered %llu ( %f %% of OR checks)\n", 
            qr->clause_redundancy_or_checks, qr->cnt_qbce_checks ? (qr->clause_redundancy_or_checks / (float)qr->cnt_qbce_checks) : 0, 
            qr->clause_redundancy_or_checks_lits_seen, qr->clause_redundancy_or_checks ? 
-           (qr->clause_redundancy_or_checks_lits_seen / (float)qr->clause_redundancy_or_checks) : 0);
+           (qr->clause_redundancy_or_checks_lits_seen / (float)qr->clause_redundancy_or_checks) : 0,
+           qr->clause_redundancy_or_checks_sig_filtered, qr->clause_redundancy_or_checks ? 
+           100 * (qr->clause_redundancy_or_checks_sig_filtered / (float)qr->clause_redundancy_or_checks) : 0);
       
   fprintf (file, "  QRATU iterations: %d\n", qr->cnt_qratu_iterations);
   fprintf (file, "  QRATU checks: %llu ( %f %% of initial CNF)\n", 
            qr->cnt_qratu_checks, qr->actual_num_clauses ? 
            ((qr->cnt_qratu_checks / (float)qr->actual_num_clauses) * 100) : 0);
+  fprintf (file, "  QRATU speculative checks discarded: %llu ( %f %% of QRATU checks)\n",
+           qr->cnt_speculative_qratu_discards, qr->cnt_qratu_checks ?
+           ((qr->cnt_speculative_qratu_discards / (float)qr->cnt_qratu_checks) * 100) : 0);
+  fprintf (file, "  QRATU wall-clock time: %f\n", qr->qratu_wall_time);
   fprintf (file, "  QRATU: %d redundant literals of %llu total univ lits ( %f %% in initial formula)\n", 
            qr->cnt_redundant_literals, qr->total_univ_lits, qr->total_univ_lits ? 
            100 * (qr->cnt_redundant_literals / ((float) qr->total_univ_lits)) : 0);
@@ -699,15 +868,65 @@ qratpreplus_preprocess (QRATPrePlus *qr)
   assert_formula_integrity (qr);
 #endif
 
+  /* The outermost qblock of a component may differ from the one of the
+     formula, hence components are not used with 'ignore_outermost_vars'. */
+  if (!qr->parsed_empty_clause && qr->options.components &&
+      !qr->options.ignore_outermost_vars && preprocess_components (qr))
+    {
+#ifndef NDEBUG
+      assert_formula_integrity (qr);
+#endif
+      return;
+    }
+
+  /* Substitution rewrites and deletes clauses, which is not allowed for
+     clauses containing outermost variables with 'ignore_outermost_vars'. */
+  if (!qr->parsed_empty_clause && qr->options.subst_equiv_lits &&
+      !qr->options.ignore_outermost_vars)
+    {
+      substitute_equivalent_literals (qr);
+#ifndef NDEBUG
+      assert_formula_integrity (qr);
+#endif
+    }
+
+  /* Adjacent qblocks of the same type were merged when parsing the
+     prefix, hence a propositional formula has one existential qblock. */
+  qr->propositional = !qr->options.no_propositional_path &&
+    qr->pcnf.qblocks.first == qr->pcnf.qblocks.last &&
+    (!qr->pcnf.qblocks.first || qr->pcnf.qblocks.first->type == QTYPE_EXISTS);
+  if (qr->propositional && qr->options.verbosity >= 1)
+    fprintf (stderr, "Propositional formula, using BCP without prefix checks\n");
+  select_qbcp_kernel (qr);
+  select_outer_tautology_kernel (qr);
+
+  order_occurrences (qr);
+  mark_clauses_exceeding_occ_limit (qr);
+
   if (!qr->time_exceeded &&
       (qr->time_exceeded = exceeded_soft_time_limit (qr)))
     fprintf (stderr, "Exceeded soft time limit of %u sec\n", qr->soft_time_limit);
   
-  if (!qr->parsed_empty_clause)
+  if (!qr->parsed_empty_clause && qr->options.priority_schedule)
+    {
+      qr->cnt_global_iterations++;
+      if (qr->options.pure_literals)
+        eliminate_pure_literals (qr, 1);
+      find_and_remove_redundancies_by_priority (qr);
+      if (!qr->time_exceeded &&
+          (qr->time_exceeded = exceeded_soft_time_limit (qr)))
+        fprintf (stderr, "Exceeded soft time limit of %u sec\n", qr->soft_time_limit);
+    }
+  else if (!qr->parsed_empty_clause)
     {
       int changed = 1;
+      double first_rate = -1;
       while (changed && !qr->time_exceeded)
         {
+          double iteration_start = wall_time_stamp ();
+          unsigned int eliminations_before =
+            qr->cnt_redundant_clauses + qr->cnt_redundant_literals;
+
           if (qr->cnt_global_iterations >= qr->limit_global_iterations)
             {
               if (qr->options.verbosity >= 1)
@@ -724,6 +943,12 @@ qratpreplus_preprocess (QRATPrePlus *qr)
 
           changed = 0;
 
+          /* Removing universal literals before AT and QRATE weakens
+             their checks, hence universal pure literals are eliminated
+             only ahead of literal elimination below. */
+          if (qr->options.pure_literals)
+            eliminate_pure_literals (qr, 0);
+
           if (!qr->options.no_qbce || !qr->options.no_qat || 
               !qr->options.no_qrate)
             find_and_mark_redundant_clauses (qr);
@@ -731,14 +956,36 @@ qratpreplus_preprocess (QRATPrePlus *qr)
           if ((qr->time_exceeded = exceeded_soft_time_limit (qr)))
             fprintf (stderr, "Exceeded soft time limit of %u sec\n", qr->soft_time_limit);
 
+          /* Remove universal pure literals ahead of BLE and QRATU. */
+          if (!qr->time_exceeded && qr->options.pure_literals &&
+              eliminate_pure_literals (qr, 1))
+            changed = 1;
+
           /* Trigger a new iteration including clause redundancy checks if any
              redundant literals were found. */
-          if (!qr->time_exceeded && (!qr->options.no_ble || !qr->options.no_qratu))
-            changed = find_and_delete_redundant_literals (qr) || changed;
+          if (!qr->time_exceeded && (!qr->options.no_ble || !qr->options.no_qratu) &&
+              find_and_delete_redundant_literals (qr))
+            {
+              changed = 1;
+              /* Shortened clauses may subsume other clauses. */
+              if (qr->options.subsumption_iterations)
+                find_and_mark_subsumed_clauses (qr);
+            }
 
           if (!qr->time_exceeded &&
               (qr->time_exceeded = exceeded_soft_time_limit (qr)))
             fprintf (stderr, "Exceeded soft time limit of %u sec\n", qr->soft_time_limit);
+
+          /* Stop if the last global iteration was much less productive
+             than the first one. The next iteration is estimated to take
+             as long as the last one. */
+          double iteration_time = wall_time_stamp () - iteration_start;
+          if (changed && !qr->time_exceeded &&
+              is_elimination_rate_diminished
+              (qr, "Global iterations", &first_rate,
+               qr->cnt_redundant_clauses + qr->cnt_redundant_literals -
+               eliminations_before, iteration_time, iteration_time))
+            changed = 0;
         }
     }
 }
@@ -113,6 +113,7 @@ typedef int LitID;
 typedef unsigned int VarID;
 typedef unsigned int ClauseID;
 typedef unsigned int Nesting;
+typedef long long unsigned int ClauseSig;
 
 enum QuantifierType
 {
@@ -132,6 +133,45 @@ enum Assignment
 
 typedef enum Assignment Assignment;
 
+/* Orderings of occurrence stacks, visited in redundancy checks. */
+enum OccOrder
+{
+  /* Insertion order. */
+  OCC_ORDER_NONE = 0,
+  /* Short clauses first. */
+  OCC_ORDER_SHORT = 1,
+  /* Move witness found in a failed check to the front. */
+  OCC_ORDER_MTF = 2,
+  /* Clauses with literals from inner qblocks first. */
+  OCC_ORDER_INNER = 3
+};
+
+typedef enum OccOrder OccOrder;
+
+enum QBCPState
+{
+  QBCP_STATE_UNKNOWN = 0,
+  QBCP_STATE_UNSAT = 20
+};
+
+typedef enum QBCPState QBCPState;
+
+/* Trace output at verbosity level 2 is removed at compile time by
+   defining 'QRATPREPLUS_NO_TRACE'. */
+#ifdef QRATPREPLUS_NO_TRACE
+#define QRATPREPLUS_TRACE(qr) 0
+#else
+#define QRATPREPLUS_TRACE(qr) ((qr)->options.verbosity >= 2)
+#endif
+
+/* Functions with constant flag arguments are instantiated as kernels for
+   the main option combinations, which requires them to be inlined. */
+#ifdef __GNUC__
+#define QRATPREPLUS_KERNEL_INLINE inline __attribute__ ((always_inline))
+#else
+#define QRATPREPLUS_KERNEL_INLINE inline
+#endif
+
 /* Invalid index of watched literal in literal array of a clause. */
 #define WATCHED_LIT_INVALID_INDEX UINT_MAX
 /* Special value indicates that clause found satisfied during watched literal
@@ -156,9 +196,33 @@ DECLARE_DLIST (Clause, Clause);
 
 DECLARE_STACK (VarID, VarID);
 DECLARE_STACK (LitID, LitID);
+DECLARE_STACK (ClauseID, ClauseID);
 DECLARE_STACK (ClausePtr, Clause *);
 DECLARE_STACK (VarPtr, Var *);
 
+/* Entry of the propagation cache used in QRAT checks: result of QBCP under
+   abstraction level 'nesting' on the assignment falsifying the outer
+   literals of the clause with ID 'occ_id' except the complement of
+   'pivot'. Slots with 'pivot == 0' are empty. */
+struct PropCacheEntry
+{
+  ClauseID occ_id;
+  LitID pivot;
+  Nesting nesting;
+  /* Literals satisfied by the assignment are stored on
+     'qr->prop_cache_lits', starting at 'offset'. */
+  unsigned int offset;
+  unsigned int cnt;
+  /* Entry is valid only if 'epoch' equals 'qr->prop_cache_epoch'. */
+  unsigned int epoch;
+  unsigned int conflict:1;
+  /* Propagation used a clause containing 'pivot'. Such entries are never
+     used to decide checks. */
+  unsigned int tainted:1;
+};
+
+typedef struct PropCacheEntry PropCacheEntry;
+
 /* PCNF object, defined by list of qblocks (quantifier prefix), array of
    variable objects (variable is indexed by its QDIMACS ID), and doubly linked
    list of clauses. */
@@ -196,6 +260,19 @@ struct Var
   /* Mark indicates if assigned variable has been propagated in
      QBCP. */
   unsigned int propagated:1;
+  /* Mark indicates that variable is on 'qr->touched_vars'. */
+  unsigned int touched:1;
+  /* Mark indicates that occurrences of the variable contain redundant
+     clauses or stale entries which have not been removed yet. */
+  unsigned int dirty:1;
+  /* Number of redundant clauses on the watched occurrences of the
+     variable. Watched occurrences are purged lazily in QBCP. */
+  unsigned int cnt_redundant_watched;
+  /* Number of stale entries on 'neg_occ_clauses' and 'pos_occ_clauses',
+     i.e., clauses from which the literal of the variable was removed. Stale
+     entries are skipped and removed in 'unlink_redundant_clauses'. */
+  unsigned int cnt_stale_neg_occs;
+  unsigned int cnt_stale_pos_occs;
   /* Stacks with pointers to clauses containing positive and negative literals
      of the variable. */
   ClausePtrStack neg_occ_clauses;
@@ -222,6 +299,9 @@ struct Clause
   /* Initial number of literals in a clause for which space was
      allocated (universal reduction may eliminate literals). */
   unsigned int size_lits;
+  /* NOTE: the array 'lits' has space for 'size_lits' literals and is
+     followed by an array of the same size holding the nesting levels of the
+     qblocks of the literals (see 'CLAUSE_NESTINGS'). */
 
   /* Index (i.e., position in 'clause->lits') of current left/right watched
      literal. We assume that literals in clauses are sorted by quantifier
@@ -248,8 +328,19 @@ struct Clause
      abstraction. Mark indicates that clause has been collected for update. */
   unsigned int lw_update_collected:1;
 
-  /* Multi-purpose mark. */
+  /* Multi-purpose mark. Used by worker threads to collect the clauses used
+     in a speculative clause check (see 'record_used_clause'). */
   unsigned int mark:1;
+  /* Mark indicating that the complementary occurrences of some literal in
+     the clause exceed the limit 'limit_max_occ_cnt'. Maintained when
+     occurrences are removed so that rescheduling need not visit the
+     literals (see 'mark_clauses_exceeding_occ_limit'). */
+  unsigned int exceeds_occ_limit:1;
+
+  /* Signature of the literals in the clause (see 'LIT2SIG'). Used to quickly
+     rule out tautological resolvents without visiting literals. Must be
+     recomputed whenever literals are removed from the clause. */
+  ClauseSig sig;
   
   /* All  clauses are kept in a doubly linked list. */
   ClauseLink link;
@@ -259,6 +350,18 @@ struct Clause
   LitID lits[];
 };
 
+/* Number of bytes to allocate for a clause with space for 'size_lits'
+   literals, including the array of nesting levels. */
+#define CLAUSE_BYTES(size_lits)                                         \
+  (sizeof (Clause) + (size_lits) * (sizeof (LitID) + sizeof (Nesting)))
+
+/* Array of nesting levels parallel to 'c->lits': entry 'i' is the nesting
+   level of the qblock of literal 'c->lits[i]'. Since literals are sorted by
+   qblock ordering, the array is sorted as well. This allows to find the
+   literals from qblocks up to a certain nesting level without accessing
+   variable objects. */
+#define CLAUSE_NESTINGS(c) ((Nesting *) ((c)->lits + (c)->size_lits))
+
 /* Some helper macros. */
 
 /* Check if literal is positive or negative. */
@@ -273,6 +376,18 @@ struct Clause
 /* Convert variable ID to pointer to variable object. */
 #define VARID2VARPTR(vars, id) ((vars) + (id))
 
+/* Map literal to one of the 64 bits of a clause signature. The variable ID is
+   hashed to one of 32 bit pairs, and the sign selects the bit in the
+   pair. Hence complementary literals are mapped to adjacent bits and the
+   signature of the clause containing the complements of all literals of a
+   clause is obtained by swapping adjacent bits by 'SIG_COMPLEMENT'. */
+#define LIT2SIG(lit)                                                    \
+  (((ClauseSig) 1) << ((((VarID) LIT2VARID (lit) * 2654435761u) >> 27) * 2 + \
+                       LIT_NEG (lit)))
+#define SIG_COMPLEMENT(sig)                             \
+  ((((sig) & 0x5555555555555555ULL) << 1) |             \
+   (((sig) >> 1) & 0x5555555555555555ULL))
+
 /* Check if qblock is existential or universal. */
 #define QBLOCK_EXISTS(s) ((s)->type == QTYPE_EXISTS)
 #define QBLOCK_FORALL(s) ((s)->type == QTYPE_FORALL)
@@ -300,6 +415,12 @@ struct QRATPrePlus
   Nesting eabs_nesting;
   /* Auxiliary variable for the computation of 'qr->eabs_nesting'. */
   Nesting eabs_nesting_aux;
+  /* Variants of QBCP and of the outer tautology check of QBCE, specialized
+     for the options and the prefix when preprocessing starts (see
+     'select_qbcp_kernel' and 'select_outer_tautology_kernel'). */
+  QBCPState (*qbcp_kernel) (QRATPrePlus *);
+  int (*outer_tautology_kernel) (QRATPrePlus *, Clause *, LitID, Clause *,
+                                 ClauseSig);
   /* Simple memory manager. */
   MemMan *mm;
   /* Declared number of clauses in QDIMACS file. */
@@ -325,6 +446,28 @@ struct QRATPrePlus
   long long unsigned int cnt_qbce_checks;
   /* Number of QRATU checks. */
   long long unsigned int cnt_qratu_checks;
+  /* Number of clause checks in QRATE or AT that were done speculatively by
+     worker threads and had to be repeated because clauses used in the check
+     were found redundant in the meantime. */
+  long long unsigned int cnt_speculative_rechecks;
+  /* Number of QRAT checks of pivots where the outer resolvents were checked
+     in parallel. */
+  long long unsigned int cnt_split_occ_checks;
+  /* Number of pivots not checked because their complementary occurrences
+     exceed 'limit_max_occ_cnt' (see option 'per_pivot_occ_limit'). */
+  long long unsigned int cnt_pivots_over_occ_limit;
+  /* Number of clause checks stopped by 'limit_max_resolvents'. */
+  long long unsigned int cnt_resolvent_limit_reached;
+  /* Number of pivots for which a witness was found and sum of the positions
+     of these witnesses among the checked occurrences. */
+  long long unsigned int cnt_witness_positions;
+  long long unsigned int sum_witness_positions;
+  /* Number of QRATU checks that were done speculatively by worker threads
+     and discarded because literals were removed from a clause checked
+     earlier. */
+  long long unsigned int cnt_speculative_qratu_discards;
+  /* Wall-clock time spent in QRATU. */
+  double qratu_wall_time;
   /* Number of QRAT QBCP checks. */
   long long unsigned int qrat_qbcp_checks;
   /* Maximum propagations allowed in a check. */
@@ -339,6 +482,28 @@ struct QRATPrePlus
   long long unsigned int qbcp_successful_checks_props;
   /* Number of successful QRAT checks. */
   long long unsigned int qrat_qbcp_successful_checks;
+  /* Number of lookups in the propagation cache, number of lookups that
+     found an entry, and number of QRAT checks decided without QBCP. */
+  long long unsigned int cnt_prop_cache_lookups;
+  long long unsigned int cnt_prop_cache_hits;
+  long long unsigned int cnt_prop_cache_decided;
+  /* Number of variables replaced by equivalent literals and number of
+     clauses deleted because they became tautological. */
+  unsigned int cnt_els_substituted_vars;
+  unsigned int cnt_els_deleted_clauses;
+  /* Number of clauses found redundant by subsumption. */
+  unsigned int cnt_subsumed_clauses;
+  /* Number of clauses and universal literals removed by pure literal
+     elimination. */
+  unsigned int cnt_pure_lit_clauses;
+  unsigned int cnt_pure_lit_univ_lits;
+  /* Number of variable-disjoint components preprocessed separately, size
+     of the largest one, and wall-clock times of the slowest component and
+     of the entire decomposition. */
+  unsigned int cnt_components;
+  unsigned int max_component_clauses;
+  double max_component_time;
+  double components_time;
   /* Assignment statistics. */
   long long unsigned int total_assignments;
 
@@ -361,6 +526,9 @@ struct QRATPrePlus
   long long unsigned int clause_redundancy_or_checks;
   /* Number of literals tested in outer resolvents checked for clause red.. */
   long long unsigned int clause_redundancy_or_checks_lits_seen;
+  /* Number of outer resolvents found non-tautological by clause signatures
+     only, i.e., without visiting literals. */
+  long long unsigned int clause_redundancy_or_checks_sig_filtered;
   
   /* Do not check redundancy of clauses if number of occurrences to be
      considered exceeds 'check_max_occ_cnt'. This limit restricts the number
@@ -374,10 +542,26 @@ struct QRATPrePlus
      literals. E.g., we might want to never check whether a unit clause has
      QRAT. */
   unsigned int limit_min_clause_len;
+  /* Stop checking a clause after 'limit_max_resolvents' outer resolvents
+     were checked, summed up over all pivots. */
+  unsigned int limit_max_resolvents;
+  /* Number of outer resolvents checked so far in the current clause
+     check. */
+  long long unsigned int cur_resolvents;
 
   /* Soft time imit in seconds: abort preprocessing and print formula,
      ignore redundant clauses and literals found so far. */
   unsigned int soft_time_limit;
+
+  /* Stop the iterations of a phase or the global iterations once the
+     number of eliminations per second in an iteration falls below
+     'min_elim_rate' percent of the rate in the first iteration (0:
+     disabled). */
+  unsigned int min_elim_rate;
+  /* Number of phases or global loops stopped due to 'min_elim_rate' and
+     estimated run time saved by stopping them. */
+  unsigned int cnt_diminishing_cutoffs;
+  double diminishing_time_saved;
   
   /* Stack of literals or variable IDs read during parsing. */
   LitIDStack parsed_literals;
@@ -393,15 +577,53 @@ struct QRATPrePlus
 
   /* Auxiliary stack to store clauses which were found to be redundant. */
   ClausePtrStack redundant_clauses;
+  /* Number of clauses on 'redundant_clauses' already unlinked from the
+     formula and from occurrences. */
+  unsigned int cnt_unlinked_redundant_clauses;
+  /* Variables with redundant clauses or stale entries on their occurrences
+     (see 'dirty' mark of variables). */
+  VarPtrStack dirty_vars;
   /* Auxiliary stack to store clauses which were found to be a witness for the
      non-redundancy of some other clause in a round. */
   ClausePtrStack witness_clauses;
+  /* Variables of clauses from which redundant literals were removed since
+     the clause elimination phases were last run. Collected variables have
+     'touched' set. */
+  VarPtrStack touched_vars;
+  /* Number of clauses on 'redundant_clauses' after QBCE and QRATE,
+     respectively, were last run. */
+  unsigned int qbce_seen_redundant;
+  unsigned int qrate_seen_redundant;
+  /* Worker threads only: clauses used in the current speculative clause
+     check. */
+  ClausePtrStack used_clauses;
+  /* Workers with private copies of the formula, available for checking
+     the outer resolvents of a pivot in parallel during QRATE, or null. */
+  struct Worker *workers;
 
   /* When using abstraction: clauses collected for literal watcher update
      during backtracking. We must maintain the invariant that the right literal
      watcher always is at an existential literal. */
   ClausePtrStack lw_update_clauses;
 
+  /* Propagation cache (see option '--prop-cache'): open hash table with
+     'size_prop_cache' slots, 'cnt_prop_cache' of them used in the current
+     epoch, and literals of the cached assignments. */
+  PropCacheEntry *prop_cache;
+  unsigned int size_prop_cache;
+  unsigned int cnt_prop_cache;
+  unsigned int prop_cache_epoch;
+  LitIDStack prop_cache_lits;
+  /* Values of 'COUNT_STACK (redundant_clauses)' and 'total_clause_lengths'
+     in the current epoch. A new epoch starts once any of them changes,
+     i.e., once clauses or literals were found redundant. */
+  unsigned int prop_cache_redundant_clauses;
+  long long unsigned int prop_cache_clause_lengths;
+  /* While computing a cache entry: set 'prop_cache_tainted' if a clause
+     containing 'prop_cache_pivot' becomes unit or conflicting. */
+  LitID prop_cache_pivot;
+  unsigned int prop_cache_tainted:1;
+
   /* Start time of program. */
   double start_time;
   unsigned int parsed_empty_clause:1;
@@ -412,6 +634,14 @@ struct QRATPrePlus
      further modifications of formula are allowed, e.g., by adding
      clauses. */
   unsigned int preprocessing_called:1;
+  /* Flag to indicate that this object is a private copy used by a worker
+     thread in parallel clause checks. Workers must not modify the shared
+     formula. */
+  unsigned int is_worker:1;
+  /* Flag to indicate that the prefix consists of a single existential
+     qblock, set when preprocessing starts. Then QBCP is plain BCP and
+     nesting levels need not be compared. */
+  unsigned int propositional:1;
 
   /* Flag to indicate that time limit was exceeded. */
   int time_exceeded;
@@ -447,6 +677,20 @@ struct QRATPrePlus
     unsigned int max_time;
     unsigned int verbosity;
     unsigned int seed;
+    /* Number of threads used for parallel QBCE and speculative QRATE, AT,
+       and QRATU (default: 1, i.e., sequential). */
+    unsigned int threads;
+    /* When using multiple threads, guarantee that the simplified formula is
+       the same as with a single thread. Speculative checks in QRATE, AT,
+       and QRATU are exact unless a QBCP propagation limit is set, in which
+       case the result of a check depends on the state of the watched
+       literals. Then these techniques are applied sequentially if this
+       option is set. */
+    unsigned int deterministic:1;
+    /* When using multiple threads in QRATE, check the outer resolvents of a
+       pivot in parallel if the number of complementary occurrences exceeds
+       'split_occs_threshold'. */
+    unsigned int split_occs_threshold;
     /* Do not eliminate clauses or eliminate literals from clauses
        that contain variables from the outermost quantifier block. */
     unsigned int ignore_outermost_vars:1;
@@ -456,15 +700,53 @@ struct QRATPrePlus
        QRAT. Since QBCE is confluent, permuting is applied to the irredundant
        clause set that remains after QBCE has been applied. */
     unsigned int permute:1;
+    /* Check clauses in lexicographic order of their literals instead of
+       by ID, so that clauses sharing outer literals are checked one after
+       the other. */
+    unsigned int group_checks:1;
     /* Exploit qblock ordering of literals in clauses to avoid visiting
        literals that only produce inadmissible inner tautologies in QBCE
-       checks. */
+       checks (enabled by default). */
     unsigned int qbce_check_taut_by_nesting:1;
     /* Check if clause is an asymmetric tautology by negating the
        clause and applying (Q)BCP (i.e., either full propositional or
        abstraction by nesting level of maximal literal in
        clause). This check is applied after QBCE and before QRAT. */
     unsigned int no_qat:1;
+    /* In global iterations after the first one, schedule only clauses
+       affected by changes since the previous iteration in AT and QRATE,
+       like in QBCE. Unlike in QBCE, this may miss redundant clauses since
+       removing literals strengthens QBCP in the entire formula. */
+    unsigned int incremental_global_iterations:1;
+    /* Instead of applying the techniques in phases until saturation, keep
+       all pairs of clauses and techniques to be checked in a single
+       priority queue ordered by estimated cost and success rate. */
+    unsigned int priority_schedule:1;
+    /* Apply 'limit_max_occ_cnt' to single pivots in clause checks, i.e.,
+       skip only the pivots with too many complementary occurrences
+       instead of not checking the entire clause. */
+    unsigned int per_pivot_occ_limit:1;
+    /* Ordering of occurrence stacks. */
+    OccOrder occ_order;
+    /* In QRAT checks, cache the propagation of the assignment derived from
+       the occurrence on the pivot, which is shared by all checks of
+       clauses containing the pivot. */
+    unsigned int prop_cache:1;
+    /* Before eliminating redundancies, replace existential literals by
+       equivalent literals found in the implication graph of binary
+       clauses. */
+    unsigned int subst_equiv_lits:1;
+    /* Mark subsumed clauses as redundant at import time and, with
+       'subsumption_iterations', also after literals were removed in a
+       global iteration. */
+    unsigned int subsumption:1;
+    unsigned int subsumption_iterations:1;
+    /* Eliminate pure literals before the clause redundancy checks of
+       every global iteration. */
+    unsigned int pure_literals:1;
+    /* Preprocess variable-disjoint components of the formula by separate
+       instances in parallel. */
+    unsigned int components:1;
     /* Use existential abstraction with respect to currently
        propagated assignments. */
     unsigned int no_eabs:1;
@@ -493,6 +775,9 @@ struct QRATPrePlus
        then the maximum assumption is treated like a decision made after the
        outermost block of existential variables. */
     unsigned int no_eabs_improved_nesting:1;
+    /* Do not use specialized propagation and tautology checks on formulas
+       with a single existential qblock. */
+    unsigned int no_propositional_path:1;
     /* Compute formula statistics. */
     unsigned int formula_stats:1;
   } options;
@@ -72,10 +72,41 @@ typedef struct QRATPrePlusApp QRATPrePlusApp;
 "    --no-qrate                    disable QRAT-based elimination of clauses (QRATE)\n" \
 "    --no-eabs                     disable prefix abstraction\n"\
 "    --no-eabs-improved-nesting    disable improved prefix abstraction\n"\
+"    --no-propositional-path       use QBCP and prefix checks also on formulas\n"\
+"                                    with a single existential qblock\n"\
+"    --subsumption                 remove subsumed and duplicate clauses when adding clauses\n"\
+"    --subsumption-iterations      remove subsumed clauses after literals were removed in a global iteration\n"\
+"    --components                  preprocess variable-disjoint parts of the formula separately, in\n"\
+"                                    parallel with '--threads' (ignored with '--ignore-outermost-vars')\n"\
+"    --pure-literals               eliminate pure literals before clause redundancy checks\n"\
+"    --subst-equiv-lits            substitute equivalent literals found in binary clauses before\n"\
+"                                    eliminating redundancies (ignored with '--ignore-outermost-vars')\n"\
+"    --prop-cache                  in QRAT checks, cache propagation of assignments from occurrences\n"\
 "    --soft-time-limit=<n>         enforce soft time limit in <n> seconds\n"\
+"    --min-elim-rate=<n>           stop iterations of a phase or global iterations once the eliminations\n" \
+"                                    per second drop below <n> %% of the first iteration (default: 0, off)\n" \
 "    --permute                     randomly permute clause lists between iterations\n" \
+"    --group-checks                check clauses sharing outer literals one after the other\n" \
+"                                    instead of in ordering of clause IDs\n" \
 "    --formula-stats               compute formula statistics before and after preprocessing\n" \
 "    --seed=<n>                    in combination with '--permute': random seed <n>(default: 0)\n" \
+"    --threads=<n>                 check clauses in QBCE, QAT, QRATE, and QRATU using <n> threads\n" \
+"                                    (default: 1)\n" \
+"    --deterministic               in combination with '--threads': always produce the same formula as\n" \
+"                                    with one thread, even if QBCP propagations are limited\n" \
+"    --split-occs-threshold=<n>    in combination with '--threads': in QRATE, check outer resolvents on a\n" \
+"                                    pivot in parallel if it has more than <n> occurrences (default: 1000)\n" \
+"    --per-pivot-occ-limit         apply '--limit-max-occ-cnt' to single pivots, i.e., skip only pivots\n" \
+"                                    with too many complementary occurrences instead of entire clauses\n" \
+"    --priority-schedule           interleave checks of all techniques in a single queue ordered by\n" \
+"                                    estimated cost and success rate instead of applying them in phases\n" \
+"                                    (sequential, i.e., '--threads' is ignored)\n" \
+"    --incremental-global-iterations  in global iterations after the first one, check only clauses\n" \
+"                                    affected by changes since the previous iteration also in QAT and\n" \
+"                                    QRATE (may find fewer redundant clauses)\n" \
+"    --occ-order=<o>               visit occurrences in redundancy checks in order <o>: 'none' (default),\n" \
+"                                    'short' (short clauses first), 'mtf' (witnesses of failed checks\n" \
+"                                    first), 'inner' (clauses with inner literals first)\n" \
 "    --ignore-outermost-vars       do not eliminate clauses or universal literals in clauses that contain\n"\
 "                                    a literal from the outermost (i.e. first) quantifier block\n" \
 "\n"
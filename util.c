@@ -23,8 +23,72 @@
 
 #include <stdarg.h>
 #include <sys/resource.h>
+#include <time.h>
 #include "util.h"
 
+/* Vectorized literal search kernels are available on x86 only and can be
+   disabled at compile time by defining 'QRATPREPLUS_NO_SIMD'. */
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(QRATPREPLUS_NO_SIMD)
+#define QRATPREPLUS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define QRATPREPLUS_X86_SIMD 0
+#endif
+
+/* Literal arrays shorter than this are always searched by the scalar loop
+   since setting up vector compares does not pay off. */
+#define FIND_LITERAL_SIMD_MIN_LEN 8
+
+static int
+find_literal_scalar (LitID lit, LitID * start, LitID * end)
+{
+  LitID *p;
+  for (p = start; p < end; p++)
+    if (*p == lit)
+      return 1;
+  return 0;
+}
+
+#if QRATPREPLUS_X86_SIMD
+
+/* Compare 4 literals per instruction. */
+__attribute__ ((target ("sse2")))
+static int
+find_literal_sse2 (LitID lit, LitID * start, LitID * end)
+{
+  const __m128i key = _mm_set1_epi32 (lit);
+  LitID *p;
+  for (p = start; p + 4 <= end; p += 4)
+    {
+      __m128i v = _mm_loadu_si128 ((const __m128i *) p);
+      if (_mm_movemask_epi8 (_mm_cmpeq_epi32 (v, key)))
+        return 1;
+    }
+  return find_literal_scalar (lit, p, end);
+}
+
+/* Compare 8 literals per instruction. */
+__attribute__ ((target ("avx2")))
+static int
+find_literal_avx2 (LitID lit, LitID * start, LitID * end)
+{
+  const __m256i key = _mm256_set1_epi32 (lit);
+  LitID *p;
+  for (p = start; p + 8 <= end; p += 8)
+    {
+      __m256i v = _mm256_loadu_si256 ((const __m256i *) p);
+      if (_mm256_movemask_epi8 (_mm256_cmpeq_epi32 (v, key)))
+        return 1;
+    }
+  return find_literal_scalar (lit, p, end);
+}
+
+#endif
+
+/* Kernel used for long literal arrays, selected at run time by
+   'select_simd_kernels'. */
+static int (*find_literal_kernel) (LitID, LitID *, LitID *) = find_literal_scalar;
+
 /* Print error message. */
 void
 print_abort_err (char *msg, ...)
@@ -77,6 +141,42 @@ time_stamp ()
   return result;
 }
 
+/* Get wall-clock time. Unlike process time, it does not include the time
+   spent by all threads of the process. */
+double
+wall_time_stamp ()
+{
+  struct timespec ts;
+  if (clock_gettime (CLOCK_MONOTONIC, &ts))
+    return 0;
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+int
+is_elimination_rate_diminished (QRATPrePlus * qr, const char *loop,
+                                double *first_rate, unsigned int eliminations,
+                                double time, double next_time)
+{
+  if (!qr->min_elim_rate)
+    return 0;
+  /* Avoid division by zero for iterations faster than the clock. */
+  double rate = eliminations / (time > 1e-6 ? time : 1e-6);
+  if (*first_rate < 0)
+    {
+      *first_rate = rate;
+      return 0;
+    }
+  if (rate * 100 >= *first_rate * qr->min_elim_rate)
+    return 0;
+
+  qr->cnt_diminishing_cutoffs++;
+  qr->diminishing_time_saved += next_time;
+  fprintf (stderr, "%s: %u eliminations per second is below %u %% of %f in first iteration, "
+           "stopping (estimated time saved: %f sec)\n", loop,
+           (unsigned int) rate, qr->min_elim_rate, *first_rate, next_time);
+  return 1;
+}
+
 int
 exceeded_soft_time_limit (QRATPrePlus * qr)
 {
@@ -103,9 +203,31 @@ count_qtype_literals (QRATPrePlus * qr, Clause * c, QuantifierType type)
   return result;
 }
 
+void
+select_simd_kernels ()
+{
+#if QRATPREPLUS_X86_SIMD
+  /* Select only once, as instances may be created while other instances
+     are running in parallel (see option '--components'). */
+  static int selected = 0;
+  if (selected)
+    return;
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    find_literal_kernel = find_literal_avx2;
+  else if (__builtin_cpu_supports ("sse2"))
+    find_literal_kernel = find_literal_sse2;
+  else
+    find_literal_kernel = find_literal_scalar;
+  selected = 1;
+#endif
+}
+
 int
 find_literal (LitID lit, LitID * start, LitID * end)
 {
+  if (end - start >= FIND_LITERAL_SIMD_MIN_LEN)
+    return find_literal_kernel (lit, start, end);
   LitID *p;
   for (p = start; p < end; p++)
     if (*p == lit)
@@ -113,6 +235,70 @@ find_literal (LitID lit, LitID * start, LitID * end)
   return 0;
 }
 
+int
+is_clause_subset (Clause * c, Clause * d)
+{
+  if (c->num_lits > d->num_lits || (c->sig & ~d->sig))
+    return 0;
+  /* Literals are sorted by nesting levels and variable IDs. */
+  Nesting *c_nestings = CLAUSE_NESTINGS (c);
+  Nesting *d_nestings = CLAUSE_NESTINGS (d);
+  unsigned int i, j = 0;
+  for (i = 0; i < c->num_lits; i++, j++)
+    {
+      LitID lit = c->lits[i];
+      while (j < d->num_lits &&
+             (d_nestings[j] < c_nestings[i] ||
+              (d_nestings[j] == c_nestings[i] &&
+               LIT2VARID (d->lits[j]) < LIT2VARID (lit))))
+        j++;
+      if (j == d->num_lits || d->lits[j] != lit)
+        return 0;
+    }
+  return 1;
+}
+
+unsigned int
+get_nesting_cutoff (Clause * c, Nesting nesting)
+{
+  /* Binary search for the first entry larger than 'nesting' in the sorted
+     array of nesting levels. */
+  Nesting *nestings = CLAUSE_NESTINGS (c);
+  unsigned int lo = 0, hi = c->num_lits;
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+      if (nestings[mid] <= nesting)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  assert (lo == c->num_lits || nestings[lo] > nesting);
+  assert (lo == 0 || nestings[lo - 1] <= nesting);
+  return lo;
+}
+
+ClauseSig
+compute_signature (LitID * start, LitID * end)
+{
+  ClauseSig result = 0;
+  LitID *p;
+  for (p = start; p < end; p++)
+    result |= LIT2SIG (*p);
+  return result;
+}
+
+void
+record_used_clause (QRATPrePlus * qr, Clause * c)
+{
+  assert (qr->is_worker);
+  if (!c->mark)
+    {
+      c->mark = 1;
+      PUSH_STACK (qr->mm, qr->used_clauses, c);
+    }
+}
+
 void
 assert_lits_sorted (QRATPrePlus * qr, LitID * lit_start, LitID * lit_end)
 {
@@ -53,14 +53,52 @@ void print_lits (QRATPrePlus * qr,
 /* Get process time. Can be used for performance statistics. */
 double time_stamp ();
 
+/* Get wall-clock time, e.g. to measure the speedup of parallel checks. */
+double wall_time_stamp ();
+
 int exceeded_soft_time_limit (QRATPrePlus * qr);
 
+/* Returns nonzero iff the iterations of 'loop' should be stopped because
+   the last iteration with 'eliminations' in 'time' seconds was much less
+   productive than the first one, and prints the decision. The rate of the
+   first iteration is stored in 'first_rate', which must be negative
+   initially. The next iteration is estimated to take 'next_time'
+   seconds. */
+int is_elimination_rate_diminished (QRATPrePlus * qr, const char *loop,
+                                    double *first_rate,
+                                    unsigned int eliminations, double time,
+                                    double next_time);
+
 unsigned int count_qtype_literals (QRATPrePlus * qr,
 				   Clause * c,
 				   QuantifierType type);
 
+/* Select vectorized kernels for literal searches based on the features of
+   the CPU the program is running on. Falls back to scalar code if no
+   supported features are available. */
+void select_simd_kernels ();
+
+/* Returns nonzero iff 'lit' appears in the array bounded by 'start' and
+   'end' (position 'end' is not part of the array). */
 int find_literal (LitID lit, LitID * start, LitID * end);
 
+/* Returns the number of literals in 'c' from qblocks with nesting level
+   smaller than or equal to 'nesting', i.e., the index of the first literal
+   in 'c' from a qblock with nesting level larger than 'nesting'. */
+unsigned int get_nesting_cutoff (Clause * c, Nesting nesting);
+
+/* Returns nonzero iff the literals of clause 'c' are a subset of the
+   literals of clause 'd', i.e., 'c' subsumes 'd'. */
+int is_clause_subset (Clause * c, Clause * d);
+
+/* Returns the signature of the literals in the array bounded by 'start'
+   and 'end'. */
+ClauseSig compute_signature (LitID * start, LitID * end);
+
+/* Record clause 'c' as used in the current clause check of a worker
+   thread. Used to validate the results of speculative checks. */
+void record_used_clause (QRATPrePlus * qr, Clause * c);
+
 void assert_lits_sorted (QRATPrePlus *, LitID *, LitID *);
 
 